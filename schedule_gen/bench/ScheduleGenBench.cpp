@@ -0,0 +1,182 @@
+#include "ScheduleChromosomes.h"
+#include "ScheduleData.h"
+#include "ScheduleDataGenerator.h"
+#include "ScheduleRandom.h"
+#include "ScheduleValidation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Times the schedule_gen hot paths on generated instances and prints the results as JSON.
+//
+// Usage: schedule_gen_bench [requests count...]
+// Without arguments the instances of 100, 1000 and 10000 requests are measured.
+// All instances and random generators are seeded with fixed values, so the runs are comparable
+// between builds.
+
+
+constexpr std::uint32_t DATA_SEED = 0x5EED;
+constexpr std::uint64_t ALGORITHM_SEED = 0xC0FFEE;
+
+constexpr std::size_t MIN_ITERATIONS = 3;
+constexpr std::chrono::nanoseconds MIN_DURATION = std::chrono::milliseconds{200};
+
+struct BenchmarkResult
+{
+    std::string Name;
+    std::size_t RequestsCount = 0;
+    std::size_t Iterations = 0;
+    double MeanNs = 0;
+    double MinNs = 0;
+};
+
+// Keeps the measured results observable, so the compiler can't drop the computations
+static volatile std::size_t benchmarkSink = 0;
+
+static void Consume(std::size_t value) { benchmarkSink = benchmarkSink + value; }
+
+template<class Operation>
+static BenchmarkResult Measure(std::string_view name, std::size_t requestsCount, Operation&& op)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::size_t iterations = 0;
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds best = std::chrono::nanoseconds::max();
+    while(iterations < MIN_ITERATIONS || total < MIN_DURATION)
+    {
+        const auto start = Clock::now();
+        op();
+        const auto elapsed =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+
+        total += elapsed;
+        best = std::min(best, elapsed);
+        ++iterations;
+    }
+
+    return BenchmarkResult{.Name = std::string(name),
+                           .RequestsCount = requestsCount,
+                           .Iterations = iterations,
+                           .MeanNs = static_cast<double>(total.count()) / iterations,
+                           .MinNs = static_cast<double>(best.count())};
+}
+
+static ScheduleData MakeBenchmarkData(std::size_t requestsCount)
+{
+    ScheduleDataGenerator generator{DATA_SEED + static_cast<std::uint32_t>(requestsCount),
+                                    ScheduleDataGeneratorParameters{.MinGroupsCount = 1,
+                                                                    .MaxGroupsCount = 5,
+                                                                    .MinLessonsCount = 1,
+                                                                    .MaxLessonsCount = 84,
+                                                                    .MinClassroomsCount = 1,
+                                                                    .MaxClassroomsCount = 7,
+                                                                    .MaxBuildingID = 3}};
+
+    return generator.GenerateData(requestsCount, requestsCount / 10);
+}
+
+static void RunBenchmarks(std::size_t requestsCount, std::vector<BenchmarkResult>& results)
+{
+    const ScheduleData data = MakeBenchmarkData(requestsCount);
+    Xoshiro256 randGen{ALGORITHM_SEED};
+
+    results.emplace_back(Measure("FillIntersectionsMatrix", requestsCount, [&] {
+        Consume(FillIntersectionsMatrix(data.SubjectRequests()).get_bit(0, requestsCount - 1));
+    }));
+
+    results.emplace_back(Measure("InitializeChromosomes", requestsCount, [&] {
+        Consume(InitializeChromosomes(data).Lessons().size());
+    }));
+
+    ScheduleChromosomes chromosomes = InitializeChromosomes(data);
+    results.emplace_back(Measure("Mutate", requestsCount, [&] {
+        Consume(Mutate(chromosomes, data, randGen));
+        chromosomes.ClearChanges();
+    }));
+
+    ScheduleChromosomes other = InitializeChromosomes(data);
+    for(std::size_t i = 0; i < requestsCount; ++i)
+        Mutate(other, data, randGen);
+
+    std::uniform_int_distribution<std::size_t> requestsDistrib(0, requestsCount - 1);
+    results.emplace_back(Measure("ReadyToCrossover/Crossover", requestsCount, [&] {
+        const auto r = requestsDistrib(randGen);
+        if(ReadyToCrossover(chromosomes, other, data, r))
+        {
+            Crossover(chromosomes, other, data, r);
+            Consume(r);
+        }
+        chromosomes.ClearChanges();
+        other.ClearChanges();
+    }));
+
+    results.emplace_back(
+        Measure("Evaluate", requestsCount, [&] { Consume(Evaluate(chromosomes, data)); }));
+
+    results.emplace_back(Measure("MakeScheduleResult", requestsCount, [&] {
+        Consume(MakeScheduleResult(chromosomes, data).items().size());
+    }));
+
+    const ScheduleResult scheduleResult = MakeScheduleResult(chromosomes, data);
+    results.emplace_back(Measure("CheckSchedule", requestsCount, [&] {
+        Consume(empty(CheckSchedule(data, scheduleResult)));
+    }));
+}
+
+static void PrintResults(std::ostream& os, const std::vector<BenchmarkResult>& results)
+{
+    os << std::fixed << std::setprecision(1);
+    os << "{\n  \"benchmarks\": [";
+    for(std::size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& result = results[i];
+        os << (i == 0 ? "\n" : ",\n");
+        os << "    {\"name\": \"" << result.Name << "\", "
+           << "\"requests\": " << result.RequestsCount << ", "
+           << "\"iterations\": " << result.Iterations << ", "
+           << "\"mean_ns\": " << result.MeanNs << ", "
+           << "\"min_ns\": " << result.MinNs << "}";
+    }
+    os << "\n  ]\n}" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::size_t> requestsCounts;
+    try
+    {
+        for(int i = 1; i < argc; ++i)
+            requestsCounts.push_back(std::stoul(argv[i]));
+    }
+    catch(const std::exception&)
+    {
+        std::cerr << "Usage: " << argv[0] << " [requests count...]" << std::endl;
+        return 1;
+    }
+
+    if(requestsCounts.empty())
+        requestsCounts = {100, 1000, 10000};
+
+    std::vector<BenchmarkResult> results;
+    for(std::size_t requestsCount : requestsCounts)
+    {
+        if(requestsCount == 0)
+        {
+            std::cerr << "Requests count must be positive" << std::endl;
+            return 1;
+        }
+
+        RunBenchmarks(requestsCount, results);
+    }
+
+    PrintResults(std::cout, results);
+    return 0;
+}
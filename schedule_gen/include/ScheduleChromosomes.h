@@ -2,27 +2,58 @@
 #include "ScheduleData.h"
 #include "ScheduleResult.h"
 
+#include <bitset>
+#include <cstdint>
+#include <limits>
 #include <random>
 #include <vector>
 
 
 class ScheduleData;
 
+// Packed genes: a lesson number and an index of the classroom
+// in the Classrooms() list of the same subject request - 3 bytes per request
+using LessonGene = std::uint8_t;
+using ClassroomGene = std::uint16_t;
+
+constexpr LessonGene NO_LESSON_GENE = std::numeric_limits<LessonGene>::max();
+constexpr ClassroomGene NO_CLASSROOM_GENE = std::numeric_limits<ClassroomGene>::max();
+constexpr ClassroomGene ANY_CLASSROOM_GENE = NO_CLASSROOM_GENE - 1;
+
+static_assert(MAX_LESSONS_COUNT < NO_LESSON_GENE, "LessonGene is too small");
+
+// Lessons occupied by a resource or a classroom
+using LessonsBitmap = std::bitset<MAX_LESSONS_COUNT>;
+
+// Lessons of the request before and after the change, they are the same if the classroom
+// is changed. Only the days of these lessons are evaluated again.
+struct GeneChange
+{
+    std::size_t Request = 0;
+    std::size_t OldLesson = NO_LESSON;
+    std::size_t NewLesson = NO_LESSON;
+};
+
 class ScheduleChromosomes
 {
 public:
-    explicit ScheduleChromosomes(std::size_t count);
-    explicit ScheduleChromosomes(std::vector<std::size_t> lessons,
-                                 std::vector<ClassroomAddress> classrooms);
+    explicit ScheduleChromosomes(const ScheduleData& data);
+    explicit ScheduleChromosomes(const ScheduleData& data,
+                                 const std::vector<std::size_t>& lessons,
+                                 const std::vector<ClassroomAddress>& classrooms);
 
-    const std::vector<std::size_t>& Lessons() const { return lessons_; }
-    const std::vector<ClassroomAddress>& Classrooms() const { return classrooms_; }
+    const std::vector<LessonGene>& Lessons() const { return lessons_; }
+    const std::vector<ClassroomGene>& Classrooms() const { return classrooms_; }
 
-    std::size_t Lesson(std::size_t r) const { return lessons_.at(r); }
-    std::size_t& Lesson(std::size_t r) { return lessons_.at(r); }
+    std::size_t Lesson(std::size_t r) const
+    {
+        const LessonGene lesson = lessons_.at(r);
+        return lesson == NO_LESSON_GENE ? NO_LESSON : lesson;
+    }
+    void SetLesson(std::size_t r, std::size_t lesson);
 
-    ClassroomAddress Classroom(std::size_t r) const { return classrooms_.at(r); }
-    ClassroomAddress& Classroom(std::size_t r) { return classrooms_.at(r); }
+    ClassroomAddress Classroom(std::size_t r) const;
+    void SetClassroom(std::size_t r, const ClassroomAddress& classroom);
 
     bool GroupsOrProfessorsOrClassroomsIntersects(const ScheduleData& data,
                                                   std::size_t currentRequest,
@@ -35,12 +66,43 @@ public:
     bool ClassroomsIntersects(std::size_t currentLesson,
                               const ClassroomAddress& currentClassroom) const;
 
-    std::size_t UnassignedLessonsCount() const;
-    std::size_t UnassignedClassroomsCount() const;
+    std::size_t UnassignedLessonsCount() const { return unassignedLessons_; }
+    std::size_t UnassignedClassroomsCount() const { return unassignedClassrooms_; }
+
+    // genes changes since the last ClearChanges() call, they drive the incremental evaluation
+    const std::vector<GeneChange>& Changes() const { return changes_; }
+    void ClearChanges() { changes_.clear(); }
+
+private:
+    static LessonGene ToLessonGene(std::size_t lesson);
+
+    std::size_t ClassroomIndex(std::size_t r) const;
+    void UpdateResourceOccupancy(std::size_t resource, std::size_t lesson);
+    void UpdateClassroomOccupancy(std::size_t classroomIndex, std::size_t lesson);
+
+    // slow path for the unassigned requests which are not tracked by the bitmaps
+    template<class Predicate>
+    bool AnyRequestAtLesson(std::size_t lesson, Predicate&& predicate) const
+    {
+        const LessonGene lessonGene = ToLessonGene(lesson);
+        for(std::size_t r = 0; r < lessons_.size(); ++r)
+        {
+            if(lessons_[r] == lessonGene && predicate(r))
+                return true;
+        }
+
+        return false;
+    }
 
 private:
-    std::vector<std::size_t> lessons_;
-    std::vector<ClassroomAddress> classrooms_;
+    const ScheduleData* pData_;
+    std::vector<LessonGene> lessons_;
+    std::vector<ClassroomGene> classrooms_;
+    std::vector<LessonsBitmap> resourcesLessons_;
+    std::vector<LessonsBitmap> classroomsLessons_;
+    std::size_t unassignedLessons_;
+    std::size_t unassignedClassrooms_;
+    std::vector<GeneChange> changes_;
 };
 
 
@@ -53,6 +115,9 @@ void InsertBlock(ScheduleChromosomes& chromosomes,
                  const SubjectsBlock& block);
 
 ScheduleChromosomes InitializeChromosomes(const ScheduleData& data);
+// Warm start: requests keep their placement in the prior schedule while it is still valid,
+// only the new, changed and conflicting requests are inserted again
+ScheduleChromosomes InitializeChromosomes(const ScheduleData& data, const ScheduleResult& prior);
 
 bool ReadyToCrossover(const ScheduleChromosomes& first,
                       const ScheduleChromosomes& second,
@@ -67,6 +132,63 @@ void Crossover(ScheduleChromosomes& first,
 std::size_t Evaluate(const ScheduleChromosomes& scheduleChromosomes,
                      const ScheduleData& scheduleData);
 
+// Penalties of one professor or one group in one day. The evaluator keeps one per day of every
+// professor and group in every individual, so the fields are as narrow as the values allow.
+struct DayEvaluation
+{
+    friend bool operator==(const DayEvaluation& lhs, const DayEvaluation& rhs) = default;
+
+    // negative if several requests share a lesson,
+    // compared as the unsigned value like in Evaluate()
+    std::int8_t LessonsGaps = 0;
+    std::uint8_t BuildingsChanges = 0;
+    std::uint32_t Complexity = 0;
+};
+
+// Caches the penalties of every professor and group per day, so after a mutation or a crossover
+// only the days of the changed genes are recalculated for their professors and groups.
+// Gives the same value as Evaluate().
+class ChromosomesEvaluator
+{
+public:
+    explicit ChromosomesEvaluator(const ScheduleChromosomes& chromosomes, const ScheduleData& data);
+
+    void Update(const ScheduleChromosomes& chromosomes);
+    std::size_t Evaluate(const ScheduleChromosomes& chromosomes) const;
+
+private:
+    // maximum of one penalty among the days and the number of days having it
+    struct PenaltyMax
+    {
+        std::size_t Value = 0;
+        std::size_t Count = 0;
+    };
+
+    template<class Penalty>
+    void UpdateMax(PenaltyMax& penaltyMax,
+                   Penalty DayEvaluation::*penalty,
+                   const DayEvaluation& oldEvaluation,
+                   const DayEvaluation& newEvaluation,
+                   std::size_t firstDay,
+                   std::size_t lastDay);
+
+    template<class Penalty>
+    void RecalculateMax(PenaltyMax& penaltyMax,
+                        Penalty DayEvaluation::*penalty,
+                        std::size_t firstDay,
+                        std::size_t lastDay);
+
+private:
+    const ScheduleData* pData_;
+    // [resource * DAYS_IN_SCHEDULE + day] for professors and groups resources
+    std::vector<DayEvaluation> days_;
+    PenaltyMax professorsLessonsGaps_;
+    PenaltyMax professorsBuildingsChanges_;
+    PenaltyMax groupsLessonsGaps_;
+    PenaltyMax groupsBuildingsChanges_;
+    PenaltyMax groupsComplexity_;
+};
+
 ScheduleResult MakeScheduleResult(const ScheduleChromosomes& chromosomes,
                                   const ScheduleData& scheduleData);
 
@@ -119,7 +241,7 @@ public:
                 for(std::size_t b = 0; b < blockRequests.size(); ++b)
                 {
                     const std::size_t subjectRequestIndex = blockRequests.at(b);
-                    chromosomes_.Lesson(subjectRequestIndex) = lesson + b;
+                    chromosomes_.SetLesson(subjectRequestIndex, lesson + b);
                 }
 
                 return;
@@ -149,7 +271,7 @@ public:
                      data_, requestIndex_, lesson)))
             {
                 mutated_ = true;
-                chromosomes_.Lesson(requestIndex_) = lesson;
+                chromosomes_.SetLesson(requestIndex_, lesson);
                 return;
             }
         }
@@ -170,7 +292,7 @@ public:
                                                       scheduleClassroom)))
             {
                 mutated_ = true;
-                chromosomes_.Classroom(requestIndex_) = scheduleClassroom;
+                chromosomes_.SetClassroom(requestIndex_, scheduleClassroom);
                 return;
             }
         }
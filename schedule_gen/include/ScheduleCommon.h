@@ -23,6 +23,8 @@ constexpr std::size_t MAX_LESSONS_COUNT = MAX_LESSONS_PER_DAY * DAYS_IN_SCHEDULE
 constexpr std::size_t NO_LESSON = std::numeric_limits<std::size_t>::max();
 constexpr std::size_t NO_BUILDING = std::numeric_limits<std::size_t>::max();
 constexpr std::size_t NOT_EVALUATED = std::numeric_limits<std::size_t>::max();
+// all penalties are non-negative: no gaps, no buildings changes, no unassigned lessons
+constexpr std::size_t EVALUATION_LOWER_BOUND = 0;
 
 
 struct ClassroomAddress
@@ -2,6 +2,8 @@
 #include "ScheduleCommon.h"
 #include "ScheduleUtils.h"
 
+#include <optional>
+#include <span>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -85,12 +87,18 @@ private:
 };
 
 
+constexpr std::size_t NO_CLASSROOM_INDEX = std::numeric_limits<std::size_t>::max();
+
 class ScheduleData
 {
 public:
     ScheduleData() = default;
     explicit ScheduleData(std::vector<SubjectRequest> subjectRequests,
                           std::vector<SubjectsBlock> blocks = {});
+    // Data with the intersections matrix of the requests computed already
+    explicit ScheduleData(std::vector<SubjectRequest> subjectRequests,
+                          std::vector<SubjectsBlock> blocks,
+                          BitIntersectionsMatrix intersectionsTable);
 
     const std::vector<SubjectRequest>& SubjectRequests() const { return subjectRequests_; }
     const std::vector<SubjectsBlock>& Blocks() const { return blocks_; }
@@ -102,25 +110,76 @@ public:
 
     bool Intersects(std::size_t lhsSubjectRequest, std::size_t rhsSubjectRequest) const;
 
-    const std::unordered_map<std::size_t, std::unordered_set<std::size_t>>& Professors() const
+    // Requests of the professors and the groups by their IDs. The tables are built from
+    // the dense resources on every call, the solve uses ProfessorRequests and GroupRequests.
+    std::unordered_map<std::size_t, std::unordered_set<std::size_t>> Professors() const;
+    std::unordered_map<std::size_t, std::unordered_set<std::size_t>> Groups() const;
+
+    bool IsInBlock(std::size_t subjectRequestIndex) const;
+    const SubjectsBlock* FindBlockByRequestIndex(std::size_t subjectRequestIndex) const;
+
+    // Professors and groups IDs are interned to dense indexes in ascending IDs order,
+    // the lists of their subject requests indexes are sorted
+    std::size_t ProfessorsCount() const { return professorsIDs_.size(); }
+    std::size_t GroupsCount() const { return groupsIDs_.size(); }
+    std::size_t ProfessorID(std::size_t professorIndex) const
     {
-        return professorRequests_;
+        return professorsIDs_.at(professorIndex);
     }
-    const std::unordered_map<std::size_t, std::unordered_set<std::size_t>>& Groups() const
+    std::size_t GroupID(std::size_t groupIndex) const { return groupsIDs_.at(groupIndex); }
+    std::size_t IndexOfProfessor(std::size_t professorID) const;
+    std::size_t IndexOfGroup(std::size_t groupID) const;
+    std::span<const std::size_t> ProfessorRequests(std::size_t professorIndex) const
     {
-        return groupRequests_;
+        return ResourceRequests(professorIndex);
+    }
+    std::span<const std::size_t> GroupRequests(std::size_t groupIndex) const
+    {
+        return ResourceRequests(ProfessorsCount() + groupIndex);
     }
 
-    bool IsInBlock(std::size_t subjectRequestIndex) const;
-    const SubjectsBlock* FindBlockByRequestIndex(std::size_t subjectRequestIndex) const;
+    // Subject request occupies resources at its lesson: the professor, the groups and
+    // the classroom if it is the only one. Requests intersect if they share a resource.
+    // Resources [0, ProfessorsCount()) are professors, the next GroupsCount() ones are groups.
+    std::size_t ResourcesCount() const { return resourceRequests_.size(); }
+    std::span<const std::size_t> RequestResources(std::size_t subjectRequestIndex) const
+    {
+        return requestResources_.row(subjectRequestIndex);
+    }
+    std::span<const std::size_t> ResourceRequests(std::size_t resource) const
+    {
+        return resourceRequests_.row(resource);
+    }
+
+    // Dense indexes of all classrooms mentioned in the subject requests except ClassroomAddress::Any()
+    std::size_t ClassroomsCount() const { return classrooms_.size(); }
+    std::optional<std::size_t> IndexOfClassroom(const ClassroomAddress& classroom) const;
+    std::span<const std::size_t> RequestClassroomsIndexes(std::size_t subjectRequestIndex) const
+    {
+        return requestClassrooms_.row(subjectRequestIndex);
+    }
+    std::span<const std::size_t> ClassroomRequests(std::size_t classroomIndex) const
+    {
+        return classroomRequests_.row(classroomIndex);
+    }
+
+private:
+    void FillRequestsTables();
+    void FillClassroomsIndexes();
+    void FillResources();
 
 private:
     std::vector<SubjectRequest> subjectRequests_;
     BitIntersectionsMatrix intersectionsTable_;
     std::vector<SubjectsBlock> blocks_;
     std::unordered_map<std::size_t, std::size_t> requestsBlocks_;
-    std::unordered_map<std::size_t, std::unordered_set<std::size_t>> professorRequests_;
-    std::unordered_map<std::size_t, std::unordered_set<std::size_t>> groupRequests_;
+    std::vector<std::size_t> professorsIDs_;
+    std::vector<std::size_t> groupsIDs_;
+    CompressedRows<std::size_t> requestResources_;
+    CompressedRows<std::size_t> resourceRequests_;
+    std::vector<ClassroomAddress> classrooms_;
+    CompressedRows<std::size_t> requestClassrooms_;
+    CompressedRows<std::size_t> classroomRequests_;
 };
 
 
@@ -134,5 +193,15 @@ std::vector<SubjectsBlock> ToSubjectsBlocks(const std::vector<SubjectRequest>& r
                                             const std::vector<std::vector<std::size_t>>& blocksIds);
 
 BitIntersectionsMatrix FillIntersectionsMatrix(const std::vector<SubjectRequest>& requests);
+// Matrix of the edited requests: intersections of the requests which are not in changedIDs
+// are copied from the previous data, only the added and modified requests are compared
+BitIntersectionsMatrix UpdateIntersectionsMatrix(const std::vector<SubjectRequest>& requests,
+                                                 const ScheduleData& previous,
+                                                 const std::vector<std::size_t>& changedIDs);
 
 std::unordered_map<std::size_t, std::size_t> FillRequestsBlocksTable(const std::vector<SubjectsBlock>& blocks);
+
+// Neighbourhood of the requests in the conflict graph: sorted indexes of the given requests and
+// of all the requests intersecting them
+std::vector<std::size_t> FindIntersectingRequests(const ScheduleData& data,
+                                                  const std::vector<std::size_t>& requests);
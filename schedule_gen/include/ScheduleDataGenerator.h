@@ -21,6 +21,9 @@ class ScheduleDataGenerator
 public:
     explicit ScheduleDataGenerator(std::random_device& randDevice,
                                    const ScheduleDataGeneratorParameters& parameters);
+    // Reproducible generator: the same seed always gives the same data
+    explicit ScheduleDataGenerator(std::mt19937::result_type seed,
+                                   const ScheduleDataGeneratorParameters& parameters);
 
     std::size_t GenerateRandomValue(std::size_t minID, std::size_t maxID);
     std::vector<std::size_t>
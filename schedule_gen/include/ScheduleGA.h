@@ -1,8 +1,14 @@
 #pragma once
 #include "ScheduleData.h"
 #include "ScheduleIndividual.h"
+#include "ScheduleWorkerPool.h"
 
+#include <atomic>
 #include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
 #include <vector>
 
 
@@ -13,6 +19,58 @@ struct ScheduleGAParams
     int SelectionCount = 0;
     int CrossoverCount = 0;
     int MutationChance = 0;
+
+    // IndividualsCount, SelectionCount, CrossoverCount and StagnationLimit are applied to each
+    // island, the solve stops when all the islands stop
+    int IslandsCount = 1;
+    // count of iterations between exchanges of the best individuals (0 - islands never exchange)
+    int MigrationInterval = 0;
+
+    // wall-clock time budget in milliseconds (0 - no limit)
+    int TimeLimit = 0;
+    // count of iterations without improvement of the best individual (0 - no limit)
+    int StagnationLimit = 0;
+
+    // master seed of all random generators of the solve (0 - random seed)
+    std::uint64_t Seed = 0;
+};
+
+enum class ScheduleGAStopReason
+{
+    IterationsLimit,
+    TimeLimit,
+    Stagnation,
+    LowerBound,
+    // stopped from outside: by the stop token or through ScheduleGAProgress::Finish
+    Cancelled
+};
+
+// State of the running solve, can be observed from other threads without stopping it
+class ScheduleGAProgress
+{
+public:
+    std::size_t Iteration() const { return iteration_.load(std::memory_order_relaxed); }
+    std::size_t BestEvaluation() const { return bestEvaluation_.load(std::memory_order_relaxed); }
+    std::size_t ImprovementIteration() const
+    {
+        return improvementIteration_.load(std::memory_order_relaxed);
+    }
+    bool Finished() const { return finished_.load(std::memory_order_relaxed); }
+    bool Cancelled() const { return StopReason() == ScheduleGAStopReason::Cancelled; }
+    std::optional<ScheduleIndividual> BestIndividual() const;
+    std::optional<ScheduleGAStopReason> StopReason() const;
+
+    void Update(std::size_t iteration, const ScheduleIndividual& individual);
+    void Finish(ScheduleGAStopReason reason);
+
+private:
+    mutable std::mutex mutex_;
+    std::optional<ScheduleIndividual> bestIndividual_;
+    std::optional<ScheduleGAStopReason> stopReason_;
+    std::atomic<std::size_t> iteration_ = 0;
+    std::atomic<std::size_t> improvementIteration_ = 0;
+    std::atomic<std::size_t> bestEvaluation_ = NOT_EVALUATED;
+    std::atomic<bool> finished_ = false;
 };
 
 class ScheduleGA
@@ -22,12 +80,40 @@ public:
 
     void SetParams(const ScheduleGAParams& params);
     const ScheduleGAParams& Params() const { return params_; }
+    // Parallel phases run on the pool if it is set, otherwise on the standard parallel algorithms
+    void SetWorkerPool(std::shared_ptr<ScheduleWorkerPool> workerPool);
 
     ScheduleIndividual operator()(const ScheduleData& scheduleData) const;
+    // Stop request is checked between iterations and inside the parallel phases,
+    // the cancelled solve returns the best individual found so far
+    ScheduleIndividual operator()(const ScheduleData& scheduleData,
+                                  ScheduleGAProgress& progress,
+                                  std::stop_token stopToken = {}) const;
+    // Warm start: the population is seeded from the prior schedule of the same requests
+    ScheduleIndividual operator()(const ScheduleData& scheduleData,
+                                  const ScheduleResult& prior,
+                                  ScheduleGAProgress& progress,
+                                  std::stop_token stopToken = {}) const;
+
+private:
+    ScheduleIndividual Run(const ScheduleData& scheduleData,
+                           const ScheduleResult* pPrior,
+                           ScheduleGAProgress& progress,
+                           std::stop_token stopToken) const;
 
 private:
     ScheduleGAParams params_ = ScheduleGA::DefaultParams();
+    std::shared_ptr<ScheduleWorkerPool> workerPool_;
 };
 
 std::ostream& operator<<(std::ostream& os, const ScheduleGAParams& params);
 ScheduleResult Generate(const ScheduleGA& generator, const ScheduleData& data);
+ScheduleResult Generate(const ScheduleGA& generator,
+                        const ScheduleData& data,
+                        ScheduleGAProgress& progress,
+                        std::stop_token stopToken = {});
+ScheduleResult Generate(const ScheduleGA& generator,
+                        const ScheduleData& data,
+                        const ScheduleResult& prior,
+                        ScheduleGAProgress& progress,
+                        std::stop_token stopToken = {});
@@ -1,5 +1,6 @@
 #pragma once
 #include "ScheduleChromosomes.h"
+#include "ScheduleRandom.h"
 
 #include <random>
 #include <vector>
@@ -10,15 +11,22 @@ class ScheduleData;
 class ScheduleIndividual
 {
 public:
-    explicit ScheduleIndividual(std::random_device& randomDevice, const ScheduleData* pData);
+    explicit ScheduleIndividual(Xoshiro256 randomGenerator, const ScheduleData* pData);
+    explicit ScheduleIndividual(Xoshiro256 randomGenerator,
+                                const ScheduleData* pData,
+                                ScheduleChromosomes chromosomes);
     void swap(ScheduleIndividual& other) noexcept;
 
+    // copy continues the same random stream as the original, the original is not changed.
+    // Copies which evolve on their own have to be reseeded.
     ScheduleIndividual(const ScheduleIndividual& other);
     ScheduleIndividual& operator=(const ScheduleIndividual& other);
 
     ScheduleIndividual(ScheduleIndividual&& other) noexcept;
     ScheduleIndividual& operator=(ScheduleIndividual&& other) noexcept;
 
+    void Reseed(Xoshiro256 randomGenerator) { randomGenerator_ = randomGenerator; }
+
     const ScheduleData& Data() const { return *pData_; }
     const ScheduleChromosomes& Chromosomes() const { return chromosomes_; }
 
@@ -27,11 +35,15 @@ public:
     std::size_t Evaluate() const;
     void Crossover(ScheduleIndividual& other);
 
+private:
+    void UpdateEvaluation();
+
 private:
     const ScheduleData* pData_;
     mutable std::size_t evaluatedValue_;
     ScheduleChromosomes chromosomes_;
-    mutable std::mt19937 randomGenerator_;
+    ChromosomesEvaluator evaluator_;
+    mutable Xoshiro256 randomGenerator_;
 };
 
 
@@ -0,0 +1,64 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+
+
+constexpr std::uint64_t SplitMix64(std::uint64_t& state)
+{
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+
+// xoshiro256** generator: 32 bytes of state instead of ~5 KB of std::mt19937.
+// Split() derives a generator with a statistically independent stream,
+// so a whole population can be seeded from a single master seed.
+class Xoshiro256
+{
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256(std::uint64_t seed = 0)
+    {
+        for(auto& s : state_)
+            s = SplitMix64(seed);
+    }
+
+    static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()()
+    {
+        const std::uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        const std::uint64_t t = state_[1] << 17;
+
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+
+        return result;
+    }
+
+    Xoshiro256 Split() { return Xoshiro256((*this)()); }
+
+    friend bool operator==(const Xoshiro256& lhs, const Xoshiro256& rhs)
+    {
+        return lhs.state_ == rhs.state_;
+    }
+    friend bool operator!=(const Xoshiro256& lhs, const Xoshiro256& rhs) { return !(lhs == rhs); }
+
+private:
+    static constexpr std::uint64_t rotl(std::uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+private:
+    std::array<std::uint64_t, 4> state_;
+};
@@ -1,6 +1,8 @@
 #pragma once
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 
@@ -126,3 +128,34 @@ private:
 private:
     BitVector data_;
 };
+
+
+// Compressed sparse rows: values of all rows are stored contiguously, row i is
+// [offsets[i], offsets[i + 1]) range of values
+template<class T> class CompressedRows
+{
+public:
+    CompressedRows() = default;
+    explicit CompressedRows(const std::vector<std::vector<T>>& rows)
+    {
+        offsets_.reserve(rows.size() + 1);
+        for(auto&& row : rows)
+        {
+            values_.insert(values_.end(), row.begin(), row.end());
+            offsets_.emplace_back(values_.size());
+        }
+    }
+
+    std::size_t size() const { return offsets_.size() - 1; }
+    const std::vector<T>& values() const { return values_; }
+
+    std::span<const T> row(std::size_t i) const
+    {
+        assert(i + 1 < offsets_.size());
+        return std::span<const T>(values_.data() + offsets_[i], values_.data() + offsets_[i + 1]);
+    }
+
+private:
+    std::vector<std::size_t> offsets_{0};
+    std::vector<T> values_;
+};
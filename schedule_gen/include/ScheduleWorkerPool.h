@@ -0,0 +1,38 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Fixed set of threads shared by all the solves of the process. The parallel phases of
+// the concurrent solves are queued to the same threads, so the solves share the cores
+// instead of oversubscribing them.
+class ScheduleWorkerPool
+{
+public:
+    // 0 - one thread per hardware core
+    explicit ScheduleWorkerPool(std::size_t threadsCount = 0);
+
+    ScheduleWorkerPool(const ScheduleWorkerPool&) = delete;
+    ScheduleWorkerPool& operator=(const ScheduleWorkerPool&) = delete;
+
+    std::size_t ThreadsCount() const { return threads_.size(); }
+
+    // Calls func for every index in [0, count) on the pool threads and waits for all the calls.
+    // The first exception of the calls is rethrown, the rest of indexes are skipped then.
+    // Must not be called from the pool threads.
+    void ParallelFor(std::size_t count, const std::function<void(std::size_t)>& func);
+
+private:
+    void Post(std::function<void()> task);
+    void WorkerLoop(std::stop_token stopToken);
+
+    std::mutex mutex_;
+    std::condition_variable_any tasksAdded_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::jthread> threads_;
+};
@@ -4,67 +4,217 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <experimental/generator>
 #include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <utility>
 
 
-ScheduleChromosomes::ScheduleChromosomes(std::size_t count)
-    : lessons_(count, NO_LESSON)
-    , classrooms_(count, ClassroomAddress::NoClassroom())
+ScheduleChromosomes::ScheduleChromosomes(const ScheduleData& data)
+    : pData_(&data)
+    , lessons_(data.SubjectRequests().size(), NO_LESSON_GENE)
+    , classrooms_(data.SubjectRequests().size(), NO_CLASSROOM_GENE)
+    , resourcesLessons_(data.ResourcesCount())
+    , classroomsLessons_(data.ClassroomsCount())
+    , unassignedLessons_(data.SubjectRequests().size())
+    , unassignedClassrooms_(data.SubjectRequests().size())
+    , changes_()
 {
 }
 
-ScheduleChromosomes::ScheduleChromosomes(std::vector<std::size_t> lessons,
-                                         std::vector<ClassroomAddress> classrooms)
-    : lessons_(std::move(lessons))
-    , classrooms_(std::move(classrooms))
+ScheduleChromosomes::ScheduleChromosomes(const ScheduleData& data,
+                                         const std::vector<std::size_t>& lessons,
+                                         const std::vector<ClassroomAddress>& classrooms)
+    : ScheduleChromosomes(data)
 {
-    assert(lessons_.size() == classrooms_.size());
+    if(lessons.size() != lessons_.size() || classrooms.size() != classrooms_.size())
+        throw std::invalid_argument("Chromosomes size doesn't match subject requests count");
+
+    for(std::size_t r = 0; r < lessons.size(); ++r)
+    {
+        SetLesson(r, lessons.at(r));
+        SetClassroom(r, classrooms.at(r));
+    }
+
+    ClearChanges();
+}
+
+void ScheduleChromosomes::SetLesson(std::size_t r, std::size_t lesson)
+{
+    const std::size_t oldLesson = Lesson(r);
+    lessons_.at(r) = ToLessonGene(lesson);
+    if(oldLesson == lesson)
+        return;
+
+    changes_.emplace_back(GeneChange{.Request = r, .OldLesson = oldLesson, .NewLesson = lesson});
+    if(oldLesson == NO_LESSON)
+        --unassignedLessons_;
+    else if(lesson == NO_LESSON)
+        ++unassignedLessons_;
+
+    const auto& resources = pData_->RequestResources(r);
+    const std::size_t classroomIndex = ClassroomIndex(r);
+    if(oldLesson != NO_LESSON)
+    {
+        for(std::size_t resource : resources)
+            UpdateResourceOccupancy(resource, oldLesson);
+
+        if(classroomIndex != NO_CLASSROOM_INDEX)
+            UpdateClassroomOccupancy(classroomIndex, oldLesson);
+    }
+
+    if(lesson != NO_LESSON)
+    {
+        for(std::size_t resource : resources)
+            resourcesLessons_[resource].set(lesson);
+
+        if(classroomIndex != NO_CLASSROOM_INDEX)
+            classroomsLessons_[classroomIndex].set(lesson);
+    }
+}
+
+ClassroomAddress ScheduleChromosomes::Classroom(std::size_t r) const
+{
+    const ClassroomGene classroom = classrooms_.at(r);
+    if(classroom == NO_CLASSROOM_GENE)
+        return ClassroomAddress::NoClassroom();
+
+    if(classroom == ANY_CLASSROOM_GENE)
+        return ClassroomAddress::Any();
+
+    return pData_->SubjectRequests().at(r).Classrooms().at(classroom);
+}
+
+void ScheduleChromosomes::SetClassroom(std::size_t r, const ClassroomAddress& classroom)
+{
+    const ClassroomGene oldClassroom = classrooms_.at(r);
+    const std::size_t oldClassroomIndex = ClassroomIndex(r);
+
+    const auto& requestClassrooms = pData_->SubjectRequests().at(r).Classrooms();
+    const auto it = std::ranges::lower_bound(requestClassrooms, classroom);
+    if(it != requestClassrooms.end() && *it == classroom)
+    {
+        const std::size_t index = std::distance(requestClassrooms.begin(), it);
+        if(index >= ANY_CLASSROOM_GENE)
+            throw std::out_of_range("Too many classrooms in subject request");
+
+        classrooms_.at(r) = static_cast<ClassroomGene>(index);
+    }
+    else if(classroom == ClassroomAddress::Any())
+    {
+        classrooms_.at(r) = ANY_CLASSROOM_GENE;
+    }
+    else if(classroom == ClassroomAddress::NoClassroom())
+    {
+        classrooms_.at(r) = NO_CLASSROOM_GENE;
+    }
+    else
+    {
+        throw std::invalid_argument("Classroom is not in the subject request classrooms list");
+    }
+
+    const ClassroomGene newClassroom = classrooms_.at(r);
+    if(newClassroom == oldClassroom)
+        return;
+
+    const std::size_t lesson = Lesson(r);
+    changes_.emplace_back(GeneChange{.Request = r, .OldLesson = lesson, .NewLesson = lesson});
+    if(oldClassroom == NO_CLASSROOM_GENE)
+        --unassignedClassrooms_;
+    else if(newClassroom == NO_CLASSROOM_GENE)
+        ++unassignedClassrooms_;
+
+    const std::size_t classroomIndex = ClassroomIndex(r);
+    if(lesson == NO_LESSON || classroomIndex == oldClassroomIndex)
+        return;
+
+    if(oldClassroomIndex != NO_CLASSROOM_INDEX)
+        UpdateClassroomOccupancy(oldClassroomIndex, lesson);
+
+    if(classroomIndex != NO_CLASSROOM_INDEX)
+        classroomsLessons_[classroomIndex].set(lesson);
+}
+
+LessonGene ScheduleChromosomes::ToLessonGene(std::size_t lesson)
+{
+    if(lesson == NO_LESSON)
+        return NO_LESSON_GENE;
+
+    if(lesson >= MAX_LESSONS_COUNT)
+        throw std::out_of_range("Lesson is out of range");
+
+    return static_cast<LessonGene>(lesson);
+}
+
+std::size_t ScheduleChromosomes::ClassroomIndex(std::size_t r) const
+{
+    const ClassroomGene classroom = classrooms_.at(r);
+    if(classroom == NO_CLASSROOM_GENE || classroom == ANY_CLASSROOM_GENE)
+        return NO_CLASSROOM_INDEX;
+
+    return pData_->RequestClassroomsIndexes(r)[classroom];
+}
+
+void ScheduleChromosomes::UpdateResourceOccupancy(std::size_t resource, std::size_t lesson)
+{
+    // several requests may share the resource at the same lesson in the invalid schedule
+    const LessonGene lessonGene = ToLessonGene(lesson);
+    resourcesLessons_[resource].set(lesson,
+                                    std::ranges::any_of(pData_->ResourceRequests(resource),
+                                                        [&](std::size_t r)
+                                                        { return lessons_[r] == lessonGene; }));
+}
+
+void ScheduleChromosomes::UpdateClassroomOccupancy(std::size_t classroomIndex, std::size_t lesson)
+{
+    const LessonGene lessonGene = ToLessonGene(lesson);
+    classroomsLessons_[classroomIndex].set(
+        lesson,
+        std::ranges::any_of(pData_->ClassroomRequests(classroomIndex),
+                            [&](std::size_t r) {
+                                return lessons_[r] == lessonGene
+                                       && ClassroomIndex(r) == classroomIndex;
+                            }));
 }
 
 bool ScheduleChromosomes::GroupsOrProfessorsOrClassroomsIntersects(const ScheduleData& data,
                                                                    std::size_t currentRequest,
                                                                    std::size_t currentLesson) const
 {
-    if(classrooms_.at(currentRequest) == ClassroomAddress::Any())
+    const ClassroomAddress currentClassroom = Classroom(currentRequest);
+    if(currentClassroom == ClassroomAddress::Any())
         return GroupsOrProfessorsIntersects(data, currentRequest, currentLesson);
 
-    const auto& requests = data.SubjectRequests();
-    const auto& thisRequest = requests.at(currentRequest);
-    auto it = std::ranges::find(lessons_, currentLesson);
-    while(it != std::end(lessons_))
+    if(currentLesson == NO_LESSON || currentClassroom == ClassroomAddress::NoClassroom())
     {
-        const std::size_t requestIndex = std::distance(std::begin(lessons_), it);
-        if(data.Intersects(currentRequest, requestIndex)
-           || classrooms_.at(currentRequest) == classrooms_.at(requestIndex))
-        {
-            return true;
-        }
-
-        it = std::ranges::find(std::next(it), std::end(lessons_), currentLesson);
+        return AnyRequestAtLesson(currentLesson,
+                                  [&](std::size_t r) {
+                                      return data.Intersects(currentRequest, r)
+                                             || currentClassroom == Classroom(r);
+                                  });
     }
 
-    return false;
+    return GroupsOrProfessorsIntersects(data, currentRequest, currentLesson)
+           || classroomsLessons_.at(ClassroomIndex(currentRequest)).test(currentLesson);
 }
 
 bool ScheduleChromosomes::GroupsOrProfessorsIntersects(const ScheduleData& data,
                                                        std::size_t currentRequest,
                                                        std::size_t currentLesson) const
 {
-    const auto& requests = data.SubjectRequests();
-    const auto& thisRequest = requests.at(currentRequest);
-    auto it = std::ranges::find(lessons_, currentLesson);
-    while(it != std::end(lessons_))
+    assert(&data == pData_);
+    if(currentLesson == NO_LESSON)
     {
-        const std::size_t requestIndex = std::distance(std::begin(lessons_), it);
-        if(data.Intersects(currentRequest, requestIndex))
-            return true;
-
-        it = std::find(std::next(it), std::end(lessons_), currentLesson);
+        return AnyRequestAtLesson(currentLesson,
+                                  [&](std::size_t r) { return data.Intersects(currentRequest, r); });
     }
 
-    return false;
+    return std::ranges::any_of(data.RequestResources(currentRequest),
+                               [&](std::size_t resource)
+                               { return resourcesLessons_.at(resource).test(currentLesson); });
 }
 
 bool ScheduleChromosomes::ClassroomsIntersects(std::size_t currentLesson,
@@ -73,28 +223,14 @@ bool ScheduleChromosomes::ClassroomsIntersects(std::size_t currentLesson,
     if(currentClassroom == ClassroomAddress::Any())
         return false;
 
-    auto it = std::ranges::find(classrooms_, currentClassroom);
-    while(it != std::end(classrooms_))
+    if(currentLesson == NO_LESSON || currentClassroom == ClassroomAddress::NoClassroom())
     {
-        const std::size_t requestIndex = std::distance(std::begin(classrooms_), it);
-        const std::size_t otherLesson = lessons_.at(requestIndex);
-        if(currentLesson == otherLesson)
-            return true;
-
-        it = std::find(std::next(it), std::end(classrooms_), currentClassroom);
+        return AnyRequestAtLesson(currentLesson,
+                                  [&](std::size_t r) { return Classroom(r) == currentClassroom; });
     }
 
-    return false;
-}
-
-std::size_t ScheduleChromosomes::UnassignedLessonsCount() const
-{
-    return std::ranges::count(lessons_, NO_LESSON);
-}
-
-std::size_t ScheduleChromosomes::UnassignedClassroomsCount() const
-{
-    return std::ranges::count(classrooms_, ClassroomAddress::NoClassroom());
+    const auto classroomIndex = pData_->IndexOfClassroom(currentClassroom);
+    return classroomIndex && classroomsLessons_.at(*classroomIndex).test(currentLesson);
 }
 
 
@@ -115,8 +251,8 @@ void InsertRequest(ScheduleChromosomes& chromosomes,
 
         if(classrooms.empty())
         {
-            chromosomes.Lesson(requestIndex) = lesson;
-            chromosomes.Classroom(requestIndex) = ClassroomAddress::Any();
+            chromosomes.SetLesson(requestIndex, lesson);
+            chromosomes.SetClassroom(requestIndex, ClassroomAddress::Any());
             return;
         }
 
@@ -124,8 +260,8 @@ void InsertRequest(ScheduleChromosomes& chromosomes,
         {
             if(!chromosomes.ClassroomsIntersects(lesson, classroom))
             {
-                chromosomes.Lesson(requestIndex) = lesson;
-                chromosomes.Classroom(requestIndex) = classroom;
+                chromosomes.SetLesson(requestIndex, lesson);
+                chromosomes.SetClassroom(requestIndex, classroom);
                 return;
             }
         }
@@ -152,8 +288,8 @@ void InsertBlock(ScheduleChromosomes& chromosomes,
 
                             if(classrooms.empty())
                             {
-                                chromosomes.Lesson(requestIndex) = lesson;
-                                chromosomes.Classroom(requestIndex) = ClassroomAddress::Any();
+                                chromosomes.SetLesson(requestIndex, lesson);
+                                chromosomes.SetClassroom(requestIndex, ClassroomAddress::Any());
                             }
                             else
                             {
@@ -166,8 +302,8 @@ void InsertBlock(ScheduleChromosomes& chromosomes,
                                 if(classroomIt == classrooms.end())
                                     return false;
 
-                                chromosomes.Lesson(requestIndex) = lesson;
-                                chromosomes.Classroom(requestIndex) = *classroomIt;
+                                chromosomes.SetLesson(requestIndex, lesson);
+                                chromosomes.SetClassroom(requestIndex, *classroomIt);
                             }
 
                             ++lesson;
@@ -180,24 +316,25 @@ void InsertBlock(ScheduleChromosomes& chromosomes,
     {
         for(std::size_t requestIndex : block.Requests())
         {
-            chromosomes.Lesson(requestIndex) = NO_LESSON;
-            chromosomes.Classroom(requestIndex) = ClassroomAddress::NoClassroom();
+            chromosomes.SetLesson(requestIndex, NO_LESSON);
+            chromosomes.SetClassroom(requestIndex, ClassroomAddress::NoClassroom());
         }
     }
 }
 
-ScheduleChromosomes InitializeChromosomes(const ScheduleData& data)
+// Inserts the blocks and the requests which have no lesson yet
+static void InsertUnassigned(ScheduleChromosomes& chromosomes, const ScheduleData& data)
 {
     const auto& requests = data.SubjectRequests();
-    assert(!requests.empty());
+    for(auto&& block : data.Blocks())
+    {
+        if(chromosomes.Lesson(block.Requests().front()) == NO_LESSON)
+            InsertBlock(chromosomes, data, block);
+    }
 
     std::vector<std::size_t> requestsIndexes(requests.size());
     std::iota(requestsIndexes.begin(), requestsIndexes.end(), 0);
 
-    ScheduleChromosomes result(requests.size());
-    for(auto&& block : data.Blocks())
-        InsertBlock(result, data, block);
-
     auto partitionPoint = std::partition(std::begin(requestsIndexes),
                                          std::end(requestsIndexes),
                                          [&](std::size_t index) { return data.IsInBlock(index); });
@@ -210,7 +347,134 @@ ScheduleChromosomes InitializeChromosomes(const ScheduleData& data)
 
     std::for_each(partitionPoint,
                   requestsIndexes.end(),
-                  [&](std::size_t r) { InsertRequest(result, data, r); });
+                  [&](std::size_t r)
+                  {
+                      if(chromosomes.Lesson(r) == NO_LESSON)
+                          InsertRequest(chromosomes, data, r);
+                  });
+}
+
+ScheduleChromosomes InitializeChromosomes(const ScheduleData& data)
+{
+    assert(!data.SubjectRequests().empty());
+
+    ScheduleChromosomes result(data);
+    InsertUnassigned(result, data);
+    result.ClearChanges();
+    return result;
+}
+
+struct PriorPlacement
+{
+    std::size_t Lesson = NO_LESSON;
+    ClassroomAddress Classroom = ClassroomAddress::NoClassroom();
+};
+
+// Placements of the prior schedule which are still allowed by the subject requests.
+// Requests placed more than once are considered changed.
+static std::vector<std::optional<PriorPlacement>> FindPriorPlacements(const ScheduleData& data,
+                                                                      const ScheduleResult& prior)
+{
+    const auto& requests = data.SubjectRequests();
+    std::vector<std::optional<PriorPlacement>> placements(requests.size());
+    std::vector<std::size_t> itemsCounts(requests.size());
+    for(auto&& item : prior)
+    {
+        const auto it =
+            std::ranges::lower_bound(requests, item.SubjectRequestID, {}, &SubjectRequest::ID);
+        if(it == requests.end() || it->ID() != item.SubjectRequestID)
+            continue;
+
+        const std::size_t r = std::distance(requests.begin(), it);
+        if(++itemsCounts.at(r) > 1)
+        {
+            placements.at(r).reset();
+            continue;
+        }
+
+        if(std::ranges::find(it->Lessons(), item.Address) == it->Lessons().end())
+            continue;
+
+        const auto& classrooms = it->Classrooms();
+        if(classrooms.empty())
+        {
+            placements.at(r) =
+                PriorPlacement{.Lesson = item.Address, .Classroom = ClassroomAddress::Any()};
+            continue;
+        }
+
+        const auto classroomIt =
+            std::ranges::find(classrooms, item.Classroom, &ClassroomAddress::Classroom);
+        if(classroomIt != classrooms.end())
+            placements.at(r) = PriorPlacement{.Lesson = item.Address, .Classroom = *classroomIt};
+    }
+
+    return placements;
+}
+
+static bool PlacePrior(ScheduleChromosomes& chromosomes,
+                       const ScheduleData& data,
+                       std::size_t r,
+                       const PriorPlacement& placement)
+{
+    if(chromosomes.GroupsOrProfessorsIntersects(data, r, placement.Lesson)
+       || chromosomes.ClassroomsIntersects(placement.Lesson, placement.Classroom))
+        return false;
+
+    chromosomes.SetLesson(r, placement.Lesson);
+    chromosomes.SetClassroom(r, placement.Classroom);
+    return true;
+}
+
+static bool PlacePriorBlock(ScheduleChromosomes& chromosomes,
+                            const ScheduleData& data,
+                            const SubjectsBlock& block,
+                            const std::vector<std::optional<PriorPlacement>>& placements)
+{
+    const auto& blockRequests = block.Requests();
+    const auto& firstPlacement = placements.at(blockRequests.front());
+    if(!firstPlacement
+       || std::ranges::find(block.Addresses(), firstPlacement->Lesson) == block.Addresses().end())
+        return false;
+
+    for(std::size_t b = 0; b < blockRequests.size(); ++b)
+    {
+        const auto& placement = placements.at(blockRequests.at(b));
+        if(!placement || placement->Lesson != firstPlacement->Lesson + b
+           || !PlacePrior(chromosomes, data, blockRequests.at(b), *placement))
+        {
+            for(std::size_t requestIndex : blockRequests)
+            {
+                chromosomes.SetLesson(requestIndex, NO_LESSON);
+                chromosomes.SetClassroom(requestIndex, ClassroomAddress::NoClassroom());
+            }
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ScheduleChromosomes InitializeChromosomes(const ScheduleData& data, const ScheduleResult& prior)
+{
+    const auto& requests = data.SubjectRequests();
+    assert(!requests.empty());
+
+    const auto placements = FindPriorPlacements(data, prior);
+    ScheduleChromosomes result(data);
+    for(auto&& block : data.Blocks())
+        PlacePriorBlock(result, data, block, placements);
+
+    for(std::size_t r = 0; r < requests.size(); ++r)
+    {
+        // the conflicting placement is kept by the request which comes first
+        if(!data.IsInBlock(r) && placements.at(r))
+            PlacePrior(result, data, r, *placements.at(r));
+    }
+
+    InsertUnassigned(result, data);
+    result.ClearChanges();
     return result;
 }
 
@@ -266,31 +530,64 @@ void Crossover(ScheduleChromosomes& first,
                const ScheduleData& data,
                std::size_t r)
 {
-    using std::swap;
-    const auto& request = data.SubjectRequests().at(r);
+    auto swapLessons = [&](std::size_t subjectRequestIndex)
+    {
+        const std::size_t firstLesson = first.Lesson(subjectRequestIndex);
+        first.SetLesson(subjectRequestIndex, second.Lesson(subjectRequestIndex));
+        second.SetLesson(subjectRequestIndex, firstLesson);
+    };
+
     auto pBlock = data.FindBlockByRequestIndex(r);
     if(pBlock != nullptr)
     {
         assert(pBlock->Requests().front() == r);
         for(std::size_t subjectRequestIndex : pBlock->Requests())
-            swap(first.Lesson(subjectRequestIndex), second.Lesson(subjectRequestIndex));
+            swapLessons(subjectRequestIndex);
     }
     else
     {
-        swap(first.Lesson(r), second.Lesson(r));
+        swapLessons(r);
     }
 
-    swap(first.Classroom(r), second.Classroom(r));
+    const ClassroomAddress firstClassroom = first.Classroom(r);
+    first.SetClassroom(r, second.Classroom(r));
+    second.SetClassroom(r, firstClassroom);
 }
 
-std::size_t Evaluate(const ScheduleChromosomes& scheduleChromosomes,
-                     const ScheduleData& scheduleData)
+template<class T>
+static T Saturate(std::size_t value)
 {
-    std::size_t maxDayComplexity = 0;
-    std::size_t maxLessonsGapsForGroups = 0;
-    std::size_t maxLessonsGapsForProfessors = 0;
-    std::size_t maxBuildingsChangesForGroups = 0;
-    std::size_t maxBuildingsChangesForProfessors = 0;
+    return static_cast<T>(std::min<std::size_t>(value, std::numeric_limits<T>::max()));
+}
+
+// the sum of the gaps wraps around if the requests share a lesson
+static std::int8_t SaturateGaps(std::size_t gaps)
+{
+    using Limits = std::numeric_limits<std::int8_t>;
+    const auto signedGaps = static_cast<std::ptrdiff_t>(gaps);
+    return static_cast<std::int8_t>(
+        std::clamp<std::ptrdiff_t>(signedGaps, Limits::min(), Limits::max()));
+}
+
+// Penalties above the range of the fields are saturated
+static DayEvaluation MakeDayEvaluation(std::size_t lessonsGaps,
+                                       std::size_t buildingsChanges,
+                                       std::size_t complexity)
+{
+    return DayEvaluation{.LessonsGaps = SaturateGaps(lessonsGaps),
+                         .BuildingsChanges = Saturate<std::uint8_t>(buildingsChanges),
+                         .Complexity = Saturate<std::uint32_t>(complexity)};
+}
+
+// lessons are pairs of [lesson, request index] of one day, sorted
+template<class LessonsIt>
+static DayEvaluation EvaluateSortedDay(const ScheduleChromosomes& scheduleChromosomes,
+                                       const ScheduleData& scheduleData,
+                                       LessonsIt firstLessonIt,
+                                       LessonsIt lastLessonIt)
+{
+    if(firstLessonIt == lastLessonIt)
+        return DayEvaluation{};
 
     auto calculateGap = [](auto&& lhs, auto&& rhs) { return lhs.first - rhs.first - 1; };
 
@@ -306,111 +603,343 @@ std::size_t Evaluate(const ScheduleChromosomes& scheduleChromosomes,
     };
 
     const auto& requests = scheduleData.SubjectRequests();
+    return MakeDayEvaluation(std::inner_product(std::next(firstLessonIt),
+                                                lastLessonIt,
+                                                firstLessonIt,
+                                                std::size_t{0},
+                                                std::plus<>{},
+                                                calculateGap),
+                             std::inner_product(std::next(firstLessonIt),
+                                                lastLessonIt,
+                                                firstLessonIt,
+                                                std::size_t{0},
+                                                std::plus<>{},
+                                                buildingsChanged),
+                             std::accumulate(firstLessonIt,
+                                             lastLessonIt,
+                                             std::size_t{0},
+                                             [&](auto accum, auto&& p) {
+                                                 return accum
+                                                        + (p.first % MAX_LESSONS_PER_DAY)
+                                                              * requests.at(p.second).Complexity();
+                                             }));
+}
+
+// dayLessons has a bit per lesson of the day, buildings are indexed by the lesson of the day
+static DayEvaluation EvaluateDayBits(std::uint8_t dayLessons,
+                                     const std::size_t* buildings,
+                                     std::size_t complexity)
+{
+    static_assert(MAX_LESSONS_PER_DAY <= 8, "Day lessons don't fit into a byte");
+
+    // gaps are the free lessons between the first and the last lessons of the day
+    const std::size_t gaps = dayLessons == 0 ? 0
+                                             : std::bit_width(dayLessons)
+                                                   - std::countr_zero(dayLessons)
+                                                   - std::popcount(dayLessons);
+
+    // buildings may change only between the adjacent lessons
+    std::size_t buildingsChanges = 0;
+    for(unsigned adjacent = dayLessons & (dayLessons >> 1); adjacent != 0; adjacent &= adjacent - 1)
+    {
+        const int l = std::countr_zero(adjacent);
+        buildingsChanges += buildings[l] != buildings[l + 1] && buildings[l] != NO_BUILDING
+                            && buildings[l + 1] != NO_BUILDING;
+    }
+
+    return MakeDayEvaluation(gaps, buildingsChanges, complexity);
+}
+
+// Day where several requests share a lesson is evaluated by sorting its lessons
+static DayEvaluation EvaluateCollisionDay(const ScheduleChromosomes& scheduleChromosomes,
+                                          const ScheduleData& scheduleData,
+                                          std::span<const std::size_t> entityRequests,
+                                          std::size_t day)
+{
     std::vector<std::pair<std::size_t, std::size_t>> lessonsBuffer;
-    for(auto&& [professor, professorRequests] : scheduleData.Professors())
+    for(std::size_t r : entityRequests)
+    {
+        const std::size_t lesson = scheduleChromosomes.Lesson(r);
+        if(lesson != NO_LESSON && lesson / MAX_LESSONS_PER_DAY == day)
+            lessonsBuffer.emplace_back(lesson, r);
+    }
+
+    std::ranges::sort(lessonsBuffer);
+    return EvaluateSortedDay(
+        scheduleChromosomes, scheduleData, lessonsBuffer.begin(), lessonsBuffer.end());
+}
+
+// Evaluates all days of one professor or group using a lessons bitmap per day.
+// Days where several requests share a lesson are evaluated as before, by sorting the lessons.
+static std::array<DayEvaluation, DAYS_IN_SCHEDULE>
+    EvaluateDays(const ScheduleChromosomes& scheduleChromosomes,
+                 const ScheduleData& scheduleData,
+                 std::span<const std::size_t> entityRequests)
+{
+    const auto& requests = scheduleData.SubjectRequests();
+
+    std::array<std::uint8_t, DAYS_IN_SCHEDULE> daysLessons{};
+    std::array<std::size_t, DAYS_IN_SCHEDULE> daysComplexity{};
+    // only the lessons present in daysLessons are read
+    std::array<std::size_t, MAX_LESSONS_COUNT> buildings;
+    std::uint32_t collisionDays = 0;
+    for(std::size_t r : entityRequests)
+    {
+        const std::size_t lesson = scheduleChromosomes.Lesson(r);
+        if(lesson == NO_LESSON)
+            continue;
+
+        const std::size_t day = lesson / MAX_LESSONS_PER_DAY;
+        const std::size_t dayLesson = lesson % MAX_LESSONS_PER_DAY;
+        const auto lessonBit = static_cast<std::uint8_t>(1u << dayLesson);
+        collisionDays |= static_cast<std::uint32_t>((daysLessons[day] & lessonBit) != 0) << day;
+        daysLessons[day] |= lessonBit;
+        daysComplexity[day] += dayLesson * requests[r].Complexity();
+        buildings[lesson] = scheduleChromosomes.Classroom(r).Building;
+    }
+
+    std::array<DayEvaluation, DAYS_IN_SCHEDULE> days{};
+    for(std::size_t day = 0; day < DAYS_IN_SCHEDULE; ++day)
+    {
+        days[day] = EvaluateDayBits(
+            daysLessons[day], buildings.data() + day * MAX_LESSONS_PER_DAY, daysComplexity[day]);
+    }
+
+    for(; collisionDays != 0; collisionDays &= collisionDays - 1)
+    {
+        const std::size_t day = std::countr_zero(collisionDays);
+        days[day] = EvaluateCollisionDay(scheduleChromosomes, scheduleData, entityRequests, day);
+    }
+
+    return days;
+}
+
+// Evaluates one day of one professor or group the same way as EvaluateDays
+static DayEvaluation EvaluateDay(const ScheduleChromosomes& scheduleChromosomes,
+                                 const ScheduleData& scheduleData,
+                                 std::span<const std::size_t> entityRequests,
+                                 std::size_t day)
+{
+    const auto& requests = scheduleData.SubjectRequests();
+
+    std::uint8_t dayLessons = 0;
+    std::size_t complexity = 0;
+    // only the lessons present in dayLessons are read
+    std::array<std::size_t, MAX_LESSONS_PER_DAY> buildings;
+    bool collision = false;
+    for(std::size_t r : entityRequests)
     {
-        lessonsBuffer.clear();
-        lessonsBuffer.reserve(professorRequests.size());
-        std::ranges::transform(professorRequests,
-                               std::back_inserter(lessonsBuffer),
-                               [&](std::size_t r) {
-                                   return std::pair{scheduleChromosomes.Lesson(r), r};
-                               });
+        const std::size_t lesson = scheduleChromosomes.Lesson(r);
+        if(lesson == NO_LESSON || lesson / MAX_LESSONS_PER_DAY != day)
+            continue;
+
+        const std::size_t dayLesson = lesson % MAX_LESSONS_PER_DAY;
+        const auto lessonBit = static_cast<std::uint8_t>(1u << dayLesson);
+        collision |= (dayLessons & lessonBit) != 0;
+        dayLessons |= lessonBit;
+        complexity += dayLesson * requests[r].Complexity();
+        buildings[dayLesson] = scheduleChromosomes.Classroom(r).Building;
+    }
+
+    if(collision)
+        return EvaluateCollisionDay(scheduleChromosomes, scheduleData, entityRequests, day);
 
-        std::ranges::sort(lessonsBuffer);
-        auto lastLesson = std::ranges::lower_bound(
-            lessonsBuffer, NO_LESSON, std::less<>{}, [](auto&& p) { return p.first; });
+    return EvaluateDayBits(dayLessons, buildings.data(), complexity);
+}
+
+// Maximums of the penalties among the days of all professors or all groups
+struct PenaltiesMax
+{
+    std::size_t LessonsGaps = 0;
+    std::size_t BuildingsChanges = 0;
+    std::size_t Complexity = 0;
+};
+
+static std::size_t EvaluationCost(const ScheduleChromosomes& scheduleChromosomes,
+                                  const PenaltiesMax& professorsMax,
+                                  const PenaltiesMax& groupsMax)
+{
+    return groupsMax.LessonsGaps * 3 + professorsMax.LessonsGaps * 2 + groupsMax.Complexity * 4
+           + professorsMax.BuildingsChanges * 64 + groupsMax.BuildingsChanges * 64
+           + scheduleChromosomes.UnassignedLessonsCount() * 128
+           + scheduleChromosomes.UnassignedClassroomsCount() * 128;
+}
 
-        for(auto firstDayLessonIt = lessonsBuffer.begin(); firstDayLessonIt != lastLesson;)
+std::size_t Evaluate(const ScheduleChromosomes& scheduleChromosomes,
+                     const ScheduleData& scheduleData)
+{
+    auto evaluateMax = [&](std::span<const std::size_t> entityRequests, PenaltiesMax& maxEvaluation)
+    {
+        for(auto&& day : EvaluateDays(scheduleChromosomes, scheduleData, entityRequests))
         {
-            const std::size_t day = firstDayLessonIt->first / MAX_LESSONS_PER_DAY;
-            const std::size_t nextDayFirstLesson = (day + 1) * MAX_LESSONS_PER_DAY;
-            const auto lastDayLessonIt = std::ranges::lower_bound(std::next(firstDayLessonIt),
-                                                                  lastLesson,
-                                                                  nextDayFirstLesson,
-                                                                  std::less<>{},
-                                                                  [](auto&& p) { return p.first; });
-
-            maxLessonsGapsForProfessors = std::max(maxLessonsGapsForProfessors,
-                                                   std::inner_product(std::next(firstDayLessonIt),
-                                                                      lastDayLessonIt,
-                                                                      firstDayLessonIt,
-                                                                      std::size_t{0},
-                                                                      std::plus<>{},
-                                                                      calculateGap));
-
-            maxBuildingsChangesForProfessors =
-                std::max(maxBuildingsChangesForProfessors,
-                         std::inner_product(std::next(firstDayLessonIt),
-                                            lastDayLessonIt,
-                                            firstDayLessonIt,
-                                            std::size_t{0},
-                                            std::plus<>{},
-                                            buildingsChanged));
-
-            firstDayLessonIt = lastDayLessonIt;
+            maxEvaluation.LessonsGaps =
+                std::max(maxEvaluation.LessonsGaps, static_cast<std::size_t>(day.LessonsGaps));
+            maxEvaluation.BuildingsChanges =
+                std::max<std::size_t>(maxEvaluation.BuildingsChanges, day.BuildingsChanges);
+            maxEvaluation.Complexity =
+                std::max<std::size_t>(maxEvaluation.Complexity, day.Complexity);
         }
+    };
+
+    PenaltiesMax professorsMax;
+    for(std::size_t p = 0; p < scheduleData.ProfessorsCount(); ++p)
+        evaluateMax(scheduleData.ProfessorRequests(p), professorsMax);
+
+    PenaltiesMax groupsMax;
+    for(std::size_t g = 0; g < scheduleData.GroupsCount(); ++g)
+        evaluateMax(scheduleData.GroupRequests(g), groupsMax);
+
+    // complexity of the day matters for the groups only
+    professorsMax.Complexity = 0;
+    return EvaluationCost(scheduleChromosomes, professorsMax, groupsMax);
+}
+
+
+ChromosomesEvaluator::ChromosomesEvaluator(const ScheduleChromosomes& chromosomes,
+                                           const ScheduleData& data)
+    : pData_(&data)
+    , days_((data.ProfessorsCount() + data.GroupsCount()) * DAYS_IN_SCHEDULE)
+{
+    for(std::size_t resource = 0; resource < data.ProfessorsCount() + data.GroupsCount(); ++resource)
+    {
+        std::ranges::copy(EvaluateDays(chromosomes, data, data.ResourceRequests(resource)),
+                          days_.begin() + resource * DAYS_IN_SCHEDULE);
     }
 
-    for(auto&& [group, groupRequests] : scheduleData.Groups())
+    const std::size_t groupsFirstDay = data.ProfessorsCount() * DAYS_IN_SCHEDULE;
+    RecalculateMax(professorsLessonsGaps_, &DayEvaluation::LessonsGaps, 0, groupsFirstDay);
+    RecalculateMax(professorsBuildingsChanges_, &DayEvaluation::BuildingsChanges, 0, groupsFirstDay);
+    RecalculateMax(groupsLessonsGaps_, &DayEvaluation::LessonsGaps, groupsFirstDay, days_.size());
+    RecalculateMax(
+        groupsBuildingsChanges_, &DayEvaluation::BuildingsChanges, groupsFirstDay, days_.size());
+    RecalculateMax(groupsComplexity_, &DayEvaluation::Complexity, groupsFirstDay, days_.size());
+}
+
+void ChromosomesEvaluator::Update(const ScheduleChromosomes& chromosomes)
+{
+    const std::size_t professorsCount = pData_->ProfessorsCount();
+    const std::size_t entitiesCount = professorsCount + pData_->GroupsCount();
+
+    // the days the requests have left and the days they have come to
+    std::vector<std::size_t> changedDays;
+    for(auto&& change : chromosomes.Changes())
     {
-        lessonsBuffer.clear();
-        lessonsBuffer.reserve(groupRequests.size());
-        std::ranges::transform(groupRequests,
-                               std::back_inserter(lessonsBuffer),
-                               [&](std::size_t r) {
-                                   return std::pair{scheduleChromosomes.Lesson(r), r};
-                               });
+        for(std::size_t resource : pData_->RequestResources(change.Request))
+        {
+            if(resource >= entitiesCount)
+                continue;
+
+            for(std::size_t lesson : {change.OldLesson, change.NewLesson})
+            {
+                if(lesson != NO_LESSON)
+                    changedDays.emplace_back(resource * DAYS_IN_SCHEDULE
+                                             + lesson / MAX_LESSONS_PER_DAY);
+            }
+        }
+    }
 
-        std::ranges::sort(lessonsBuffer);
-        auto lastLesson = std::ranges::lower_bound(
-            lessonsBuffer, NO_LESSON, std::less<>{}, [](auto&& p) { return p.first; });
+    std::ranges::sort(changedDays);
+    changedDays.erase(std::unique(changedDays.begin(), changedDays.end()), changedDays.end());
 
-        for(auto firstDayLessonIt = lessonsBuffer.begin(); firstDayLessonIt != lastLesson;)
+    const std::size_t groupsFirstDay = professorsCount * DAYS_IN_SCHEDULE;
+    for(std::size_t d : changedDays)
+    {
+        const std::size_t resource = d / DAYS_IN_SCHEDULE;
+        const DayEvaluation oldEvaluation = days_.at(d);
+        const DayEvaluation newEvaluation = EvaluateDay(
+            chromosomes, *pData_, pData_->ResourceRequests(resource), d % DAYS_IN_SCHEDULE);
+        if(oldEvaluation == newEvaluation)
+            continue;
+
+        days_.at(d) = newEvaluation;
+        if(d < groupsFirstDay)
         {
-            const std::size_t day = firstDayLessonIt->first / MAX_LESSONS_PER_DAY;
-            const std::size_t nextDayFirstLesson = (day + 1) * MAX_LESSONS_PER_DAY;
-            const auto lastDayLessonIt = std::ranges::lower_bound(std::next(firstDayLessonIt),
-                                                                  lastLesson,
-                                                                  nextDayFirstLesson,
-                                                                  std::less<>{},
-                                                                  [](auto&& p) { return p.first; });
-
-            maxLessonsGapsForGroups = std::max(maxLessonsGapsForGroups,
-                                               std::inner_product(std::next(firstDayLessonIt),
-                                                                  lastDayLessonIt,
-                                                                  firstDayLessonIt,
-                                                                  std::size_t{0},
-                                                                  std::plus<>{},
-                                                                  calculateGap));
-
-            maxBuildingsChangesForGroups = std::max(maxBuildingsChangesForGroups,
-                                                    std::inner_product(std::next(firstDayLessonIt),
-                                                                       lastDayLessonIt,
-                                                                       firstDayLessonIt,
-                                                                       std::size_t{0},
-                                                                       std::plus<>{},
-                                                                       buildingsChanged));
-
-            maxDayComplexity =
-                std::max(maxDayComplexity,
-                         std::accumulate(firstDayLessonIt,
-                                         lastDayLessonIt,
-                                         std::size_t{0},
-                                         [&](auto accum, auto&& p) {
-                                             return accum
-                                                    + (p.first % MAX_LESSONS_PER_DAY)
-                                                          * requests.at(p.second).Complexity();
-                                         }));
-
-            firstDayLessonIt = lastDayLessonIt;
+            UpdateMax(professorsLessonsGaps_,
+                      &DayEvaluation::LessonsGaps,
+                      oldEvaluation,
+                      newEvaluation,
+                      0,
+                      groupsFirstDay);
+            UpdateMax(professorsBuildingsChanges_,
+                      &DayEvaluation::BuildingsChanges,
+                      oldEvaluation,
+                      newEvaluation,
+                      0,
+                      groupsFirstDay);
+        }
+        else
+        {
+            UpdateMax(groupsLessonsGaps_,
+                      &DayEvaluation::LessonsGaps,
+                      oldEvaluation,
+                      newEvaluation,
+                      groupsFirstDay,
+                      days_.size());
+            UpdateMax(groupsBuildingsChanges_,
+                      &DayEvaluation::BuildingsChanges,
+                      oldEvaluation,
+                      newEvaluation,
+                      groupsFirstDay,
+                      days_.size());
+            UpdateMax(groupsComplexity_,
+                      &DayEvaluation::Complexity,
+                      oldEvaluation,
+                      newEvaluation,
+                      groupsFirstDay,
+                      days_.size());
         }
     }
+}
 
-    return maxLessonsGapsForGroups * 3 + maxLessonsGapsForProfessors * 2 + maxDayComplexity * 4
-           + maxBuildingsChangesForProfessors * 64 + maxBuildingsChangesForGroups * 64
-           + scheduleChromosomes.UnassignedLessonsCount() * 128
-           + scheduleChromosomes.UnassignedClassroomsCount() * 128;
+std::size_t ChromosomesEvaluator::Evaluate(const ScheduleChromosomes& chromosomes) const
+{
+    return EvaluationCost(chromosomes,
+                          PenaltiesMax{.LessonsGaps = professorsLessonsGaps_.Value,
+                                       .BuildingsChanges = professorsBuildingsChanges_.Value},
+                          PenaltiesMax{.LessonsGaps = groupsLessonsGaps_.Value,
+                                       .BuildingsChanges = groupsBuildingsChanges_.Value,
+                                       .Complexity = groupsComplexity_.Value});
+}
+
+template<class Penalty>
+void ChromosomesEvaluator::UpdateMax(PenaltyMax& penaltyMax,
+                                     Penalty DayEvaluation::*penalty,
+                                     const DayEvaluation& oldEvaluation,
+                                     const DayEvaluation& newEvaluation,
+                                     std::size_t firstDay,
+                                     std::size_t lastDay)
+{
+    const auto oldValue = static_cast<std::size_t>(oldEvaluation.*penalty);
+    const auto newValue = static_cast<std::size_t>(newEvaluation.*penalty);
+    if(newValue > penaltyMax.Value)
+    {
+        penaltyMax = PenaltyMax{.Value = newValue, .Count = 1};
+        return;
+    }
+
+    if(newValue == penaltyMax.Value)
+        ++penaltyMax.Count;
+
+    // the last day with the maximum has gone, so look for the new maximum
+    if(oldValue == penaltyMax.Value && --penaltyMax.Count == 0)
+        RecalculateMax(penaltyMax, penalty, firstDay, lastDay);
+}
+
+template<class Penalty>
+void ChromosomesEvaluator::RecalculateMax(PenaltyMax& penaltyMax,
+                                          Penalty DayEvaluation::*penalty,
+                                          std::size_t firstDay,
+                                          std::size_t lastDay)
+{
+    penaltyMax = PenaltyMax{};
+    for(std::size_t d = firstDay; d < lastDay; ++d)
+    {
+        const auto value = static_cast<std::size_t>(days_.at(d).*penalty);
+        if(value > penaltyMax.Value)
+            penaltyMax = PenaltyMax{.Value = value, .Count = 1};
+        else if(value == penaltyMax.Value)
+            ++penaltyMax.Count;
+    }
 }
 
 ScheduleResult MakeScheduleResult(const ScheduleChromosomes& chromosomes,
@@ -426,12 +955,12 @@ ScheduleResult MakeScheduleResult(const ScheduleChromosomes& chromosomes,
         while(it != std::end(lessons))
         {
             const std::size_t r = std::distance(std::begin(lessons), it);
-            if(classrooms.at(r) != ClassroomAddress::NoClassroom())
+            if(classrooms.at(r) != NO_CLASSROOM_GENE)
             {
                 const auto& request = scheduleData.SubjectRequests().at(r);
                 resultSchedule.insert(ScheduleItem{.Address = l,
                                                    .SubjectRequestID = request.ID(),
-                                                   .Classroom = classrooms.at(r).Classroom});
+                                                   .Classroom = chromosomes.Classroom(r).Classroom});
             }
 
             it = std::ranges::find(std::next(it), lessons.end(), l);
@@ -3,6 +3,7 @@
 #include "ScheduleUtils.h"
 
 #include <algorithm>
+#include <limits>
 #include <string>
 
 
@@ -36,25 +37,164 @@ ScheduleData::ScheduleData(std::vector<SubjectRequest> subjectRequests,
     , intersectionsTable_(FillIntersectionsMatrix(subjectRequests_))
     , blocks_(std::move(blocks))
     , requestsBlocks_(FillRequestsBlocksTable(blocks_))
-    , professorRequests_()
-    , groupRequests_()
+{
+    FillRequestsTables();
+}
+
+ScheduleData::ScheduleData(std::vector<SubjectRequest> subjectRequests,
+                           std::vector<SubjectsBlock> blocks,
+                           BitIntersectionsMatrix intersectionsTable)
+    : subjectRequests_(std::move(subjectRequests))
+    , intersectionsTable_(std::move(intersectionsTable))
+    , blocks_(std::move(blocks))
+    , requestsBlocks_(FillRequestsBlocksTable(blocks_))
+{
+    FillRequestsTables();
+}
+
+void ScheduleData::FillRequestsTables()
 {
     assert(std::ranges::is_sorted(subjectRequests_, {}, &SubjectRequest::ID));
 
+    FillClassroomsIndexes();
+    FillResources();
+}
+
+void ScheduleData::FillClassroomsIndexes()
+{
+    for(auto&& request : subjectRequests_)
+        std::ranges::copy(request.Classrooms(), std::back_inserter(classrooms_));
+
+    std::ranges::sort(classrooms_);
+    classrooms_.erase(std::unique(classrooms_.begin(), classrooms_.end()), classrooms_.end());
+    if(auto it = std::ranges::lower_bound(classrooms_, ClassroomAddress::Any());
+       it != classrooms_.end() && *it == ClassroomAddress::Any())
+        classrooms_.erase(it);
+
+    std::vector<std::vector<std::size_t>> requestClassrooms(subjectRequests_.size());
+    std::vector<std::vector<std::size_t>> classroomRequests(classrooms_.size());
+    for(std::size_t r = 0; r < subjectRequests_.size(); ++r)
+    {
+        for(auto&& classroom : subjectRequests_.at(r).Classrooms())
+        {
+            const auto index = IndexOfClassroom(classroom);
+            requestClassrooms.at(r).emplace_back(index.value_or(NO_CLASSROOM_INDEX));
+            if(index)
+                classroomRequests.at(*index).emplace_back(r);
+        }
+    }
+
+    requestClassrooms_ = CompressedRows<std::size_t>(requestClassrooms);
+    classroomRequests_ = CompressedRows<std::size_t>(classroomRequests);
+}
+
+void ScheduleData::FillResources()
+{
+    for(auto&& request : subjectRequests_)
+    {
+        professorsIDs_.emplace_back(request.Professor());
+        std::ranges::copy(request.Groups(), std::back_inserter(groupsIDs_));
+    }
+
+    std::ranges::sort(professorsIDs_);
+    professorsIDs_.erase(std::unique(professorsIDs_.begin(), professorsIDs_.end()),
+                         professorsIDs_.end());
+    std::ranges::sort(groupsIDs_);
+    groupsIDs_.erase(std::unique(groupsIDs_.begin(), groupsIDs_.end()), groupsIDs_.end());
+
+    // professors get the first resources indexes, groups get the next ones, classrooms go last
+    std::unordered_map<std::size_t, std::size_t> classroomsResources;
+    auto classroomResource = [&](const ClassroomAddress& classroom)
+    {
+        // FillIntersectionsMatrix compares the classrooms as is, so Any() is a resource here too
+        const std::size_t key = classroom == ClassroomAddress::Any() ? classrooms_.size()
+                                                                     : *IndexOfClassroom(classroom);
+        const std::size_t next = ProfessorsCount() + GroupsCount() + classroomsResources.size();
+        return classroomsResources.try_emplace(key, next).first->second;
+    };
+
+    std::vector<std::vector<std::size_t>> requestResources(subjectRequests_.size());
     for(std::size_t r = 0; r < subjectRequests_.size(); ++r)
     {
         const auto& request = subjectRequests_.at(r);
-        professorRequests_[request.Professor()].insert(r);
+        auto& resources = requestResources.at(r);
+        resources.emplace_back(IndexOfProfessor(request.Professor()));
         for(std::size_t g : request.Groups())
-            groupRequests_[g].insert(r);
+            resources.emplace_back(ProfessorsCount() + IndexOfGroup(g));
+
+        if(request.Classrooms().size() == 1)
+            resources.emplace_back(classroomResource(request.Classrooms().front()));
+
+        std::ranges::sort(resources);
+        resources.erase(std::unique(resources.begin(), resources.end()), resources.end());
     }
 
-    // effectively rehash tables (shrink to fit) - yes, it realy increases the performance when accessing them!
-    professorRequests_ =
-        std::unordered_map<std::size_t, std::unordered_set<std::size_t>>(professorRequests_);
+    std::vector<std::vector<std::size_t>> resourceRequests(ProfessorsCount() + GroupsCount()
+                                                           + classroomsResources.size());
+    for(std::size_t r = 0; r < subjectRequests_.size(); ++r)
+    {
+        for(std::size_t resource : requestResources.at(r))
+            resourceRequests.at(resource).emplace_back(r);
+    }
+
+    requestResources_ = CompressedRows<std::size_t>(requestResources);
+    resourceRequests_ = CompressedRows<std::size_t>(resourceRequests);
+}
 
-    groupRequests_ =
-        std::unordered_map<std::size_t, std::unordered_set<std::size_t>>(groupRequests_);
+std::unordered_map<std::size_t, std::unordered_set<std::size_t>> ScheduleData::Professors() const
+{
+    std::unordered_map<std::size_t, std::unordered_set<std::size_t>> professors;
+    professors.reserve(ProfessorsCount());
+    for(std::size_t p = 0; p < ProfessorsCount(); ++p)
+    {
+        const auto requests = ProfessorRequests(p);
+        professors.emplace(ProfessorID(p),
+                           std::unordered_set<std::size_t>(requests.begin(), requests.end()));
+    }
+
+    return professors;
+}
+
+std::unordered_map<std::size_t, std::unordered_set<std::size_t>> ScheduleData::Groups() const
+{
+    std::unordered_map<std::size_t, std::unordered_set<std::size_t>> groups;
+    groups.reserve(GroupsCount());
+    for(std::size_t g = 0; g < GroupsCount(); ++g)
+    {
+        const auto requests = GroupRequests(g);
+        groups.emplace(GroupID(g),
+                       std::unordered_set<std::size_t>(requests.begin(), requests.end()));
+    }
+
+    return groups;
+}
+
+std::size_t ScheduleData::IndexOfProfessor(std::size_t professorID) const
+{
+    auto it = std::ranges::lower_bound(professorsIDs_, professorID);
+    if(it == professorsIDs_.end() || *it != professorID)
+        throw std::out_of_range("Professor with ID=" + std::to_string(professorID)
+                                + " is not found!");
+
+    return std::distance(professorsIDs_.begin(), it);
+}
+
+std::size_t ScheduleData::IndexOfGroup(std::size_t groupID) const
+{
+    auto it = std::ranges::lower_bound(groupsIDs_, groupID);
+    if(it == groupsIDs_.end() || *it != groupID)
+        throw std::out_of_range("Group with ID=" + std::to_string(groupID) + " is not found!");
+
+    return std::distance(groupsIDs_.begin(), it);
+}
+
+std::optional<std::size_t> ScheduleData::IndexOfClassroom(const ClassroomAddress& classroom) const
+{
+    auto it = std::ranges::lower_bound(classrooms_, classroom);
+    if(it == classrooms_.end() || *it != classroom)
+        return std::nullopt;
+
+    return std::distance(classrooms_.begin(), it);
 }
 
 bool ScheduleData::Intersects(std::size_t lhsSubjectRequest, std::size_t rhsSubjectRequest) const
@@ -112,7 +252,7 @@ std::vector<std::size_t> SelectBlockFirstLessons(const std::vector<SubjectReques
     for(std::size_t firstLesson : requests.at(block.front()).Lessons())
     {
         bool matches = true;
-        for(std::size_t i = 1, l = firstLesson; i < block.size(); ++i, ++l)
+        for(std::size_t i = 1, l = firstLesson + 1; i < block.size(); ++i, ++l)
         {
             const auto& lessons = requests.at(block.at(i)).Lessons();
             matches = LessonsAreInSameDay(firstLesson, l) && std::binary_search(lessons.begin(), lessons.end(), l);
@@ -163,23 +303,57 @@ std::vector<SubjectsBlock> ToSubjectsBlocks(const std::vector<SubjectRequest>& r
     return subjectsBlocks;
 }
 
+static bool RequestsIntersect(const SubjectRequest& thisRequest, const SubjectRequest& otherRequest)
+{
+    return thisRequest.Professor() == otherRequest.Professor()
+           || set_intersects(thisRequest.Groups(), otherRequest.Groups())
+           || (thisRequest.Classrooms().size() == 1 && otherRequest.Classrooms().size() == 1
+               && thisRequest.Classrooms().front() == otherRequest.Classrooms().front());
+}
+
 BitIntersectionsMatrix FillIntersectionsMatrix(const std::vector<SubjectRequest>& requests)
 {
+    BitIntersectionsMatrix mtx(requests.size());
+    for(std::size_t i = 1; i < requests.size(); ++i)
+    {
+        for(std::size_t j = 0; j < i; ++j)
+            mtx.set_bit(i, j, RequestsIntersect(requests[i], requests[j]));
+    }
+
+    return mtx;
+}
+
+BitIntersectionsMatrix UpdateIntersectionsMatrix(const std::vector<SubjectRequest>& requests,
+                                                 const ScheduleData& previous,
+                                                 const std::vector<std::size_t>& changedIDs)
+{
+    // indexes of the unchanged requests in the previous data, both are sorted by IDs
+    constexpr std::size_t CHANGED = std::numeric_limits<std::size_t>::max();
+    const auto& previousRequests = previous.SubjectRequests();
+    std::vector<std::size_t> previousIndexes(requests.size(), CHANGED);
+    auto previousIt = previousRequests.begin();
+    for(std::size_t i = 0; i < requests.size(); ++i)
+    {
+        const std::size_t id = requests[i].ID();
+        previousIt = std::ranges::lower_bound(
+            previousIt, previousRequests.end(), id, {}, &SubjectRequest::ID);
+        if(previousIt != previousRequests.end() && previousIt->ID() == id
+           && std::ranges::find(changedIDs, id) == changedIDs.end())
+            previousIndexes[i] = static_cast<std::size_t>(previousIt - previousRequests.begin());
+    }
+
     BitIntersectionsMatrix mtx(requests.size());
     for(std::size_t i = 1; i < requests.size(); ++i)
     {
         for(std::size_t j = 0; j < i; ++j)
         {
-            const auto& thisRequest = requests[i];
-            const auto& otherRequest = requests[j];
-            mtx.set_bit(
-                i,
-                j,
-                thisRequest.Professor() == otherRequest.Professor()
-                    || set_intersects(thisRequest.Groups(), otherRequest.Groups())
-                    || (thisRequest.Classrooms().size() == 1
-                        && otherRequest.Classrooms().size() == 1
-                        && thisRequest.Classrooms().front() == otherRequest.Classrooms().front()));
+            const std::size_t previousI = previousIndexes[i];
+            const std::size_t previousJ = previousIndexes[j];
+            mtx.set_bit(i,
+                        j,
+                        previousI != CHANGED && previousJ != CHANGED
+                            ? previous.Intersects(previousI, previousJ)
+                            : RequestsIntersect(requests[i], requests[j]));
         }
     }
 
@@ -204,3 +378,18 @@ std::unordered_map<std::size_t, std::size_t> FillRequestsBlocksTable(const std::
 
     return requestsBlocks;
 }
+
+std::vector<std::size_t> FindIntersectingRequests(const ScheduleData& data,
+                                                  const std::vector<std::size_t>& requests)
+{
+    std::vector<std::size_t> result;
+    for(std::size_t r = 0; r < data.SubjectRequests().size(); ++r)
+    {
+        const bool intersects = std::ranges::any_of(
+            requests, [&](std::size_t request) { return data.Intersects(r, request); });
+        if(intersects)
+            result.emplace_back(r);
+    }
+
+    return result;
+}
@@ -7,7 +7,13 @@ constexpr std::size_t MAX_BLOCK_SIZE = 4;
 
 ScheduleDataGenerator::ScheduleDataGenerator(std::random_device& randDevice,
                                              const ScheduleDataGeneratorParameters& parameters)
-    : randGen_(randDevice())
+    : ScheduleDataGenerator(randDevice(), parameters)
+{
+}
+
+ScheduleDataGenerator::ScheduleDataGenerator(std::mt19937::result_type seed,
+                                             const ScheduleDataGeneratorParameters& parameters)
+    : randGen_(seed)
     , parameters_(parameters)
 {
     if(parameters_.MinGroupsCount < 1)
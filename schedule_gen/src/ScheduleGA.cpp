@@ -1,7 +1,9 @@
 #include "ScheduleGA.h"
 
 #include <algorithm>
+#include <exception>
 #include <execution>
+#include <thread>
 
 
 void ScheduleGA::SetParams(const ScheduleGAParams& params)
@@ -25,72 +27,393 @@ void ScheduleGA::SetParams(const ScheduleGAParams& params)
     if(params.MutationChance < 0 || params.MutationChance > 100)
         throw std::invalid_argument("Invalid MutationChance option: must be in range [0, 100]");
 
+    if(params.IslandsCount <= 0)
+        throw std::invalid_argument("Invalid IslandsCount option: must be greater than zero");
+
+    if(params.MigrationInterval < 0)
+        throw std::invalid_argument(
+            "Invalid MigrationInterval option: must be greater or equal to zero");
+
+    if(params.TimeLimit < 0)
+        throw std::invalid_argument("Invalid TimeLimit option: must be greater or equal to zero");
+
+    if(params.StagnationLimit < 0)
+        throw std::invalid_argument(
+            "Invalid StagnationLimit option: must be greater or equal to zero");
+
     params_ = params;
 }
 
+void ScheduleGA::SetWorkerPool(std::shared_ptr<ScheduleWorkerPool> workerPool)
+{
+    workerPool_ = std::move(workerPool);
+}
+
 ScheduleGAParams ScheduleGA::DefaultParams()
 {
     return ScheduleGAParams{.IndividualsCount = 1000,
                             .IterationsCount = 1100,
                             .SelectionCount = 360,
                             .CrossoverCount = 220,
-                            .MutationChance = 49};
+                            .MutationChance = 49,
+                            .IslandsCount = 1,
+                            .MigrationInterval = 50,
+                            .TimeLimit = 0,
+                            .StagnationLimit = 0,
+                            .Seed = 0};
 }
 
-ScheduleIndividual ScheduleGA::operator()(const ScheduleData& scheduleData) const
+std::optional<ScheduleIndividual> ScheduleGAProgress::BestIndividual() const
+{
+    std::lock_guard lock(mutex_);
+    return bestIndividual_;
+}
+
+std::optional<ScheduleGAStopReason> ScheduleGAProgress::StopReason() const
+{
+    std::lock_guard lock(mutex_);
+    return stopReason_;
+}
+
+void ScheduleGAProgress::Update(std::size_t iteration, const ScheduleIndividual& individual)
+{
+    std::size_t lastIteration = iteration_.load(std::memory_order_relaxed);
+    while(lastIteration < iteration
+          && !iteration_.compare_exchange_weak(lastIteration, iteration, std::memory_order_relaxed))
+        ;
+
+    // cheap check without locking: the most of updates do not improve the best individual
+    if(individual.Evaluate() >= BestEvaluation())
+        return;
+
+    std::lock_guard lock(mutex_);
+    if(individual.Evaluate() >= BestEvaluation())
+        return;
+
+    bestIndividual_ = individual;
+    bestEvaluation_.store(individual.Evaluate(), std::memory_order_relaxed);
+    improvementIteration_.store(iteration, std::memory_order_relaxed);
+}
+
+void ScheduleGAProgress::Finish(ScheduleGAStopReason reason)
+{
+    std::lock_guard lock(mutex_);
+    if(stopReason_)
+        return;
+
+    stopReason_ = reason;
+    finished_.store(true, std::memory_order_relaxed);
+}
+
+struct ScheduleGAIsland
+{
+    std::vector<ScheduleIndividual> Individuals;
+    Xoshiro256 RandomGenerator;
+};
+
+using ScheduleGAClock = std::chrono::steady_clock;
+
+static std::uint64_t RandomSeed()
 {
     std::random_device randomDevice;
-    const ScheduleIndividual firstIndividual(randomDevice, &scheduleData);
-    firstIndividual.Evaluate();
+    return (static_cast<std::uint64_t>(randomDevice()) << 32) | randomDevice();
+}
+
+static bool StopRequested(std::stop_token stopToken, ScheduleGAProgress& progress)
+{
+    if(!stopToken.stop_requested())
+        return false;
+
+    progress.Finish(ScheduleGAStopReason::Cancelled);
+    return true;
+}
+
+static bool ShouldStop(const ScheduleGAParams& params,
+                       ScheduleGAClock::time_point deadline,
+                       std::stop_token stopToken,
+                       ScheduleGAProgress& progress)
+{
+    if(progress.Finished() || StopRequested(stopToken, progress))
+        return true;
+
+    if(progress.BestEvaluation() <= EVALUATION_LOWER_BOUND)
+        progress.Finish(ScheduleGAStopReason::LowerBound);
+    else if(params.StagnationLimit > 0
+            && progress.Iteration()
+                   >= progress.ImprovementIteration() + params.StagnationLimit)
+        progress.Finish(ScheduleGAStopReason::Stagnation);
+    else if(ScheduleGAClock::now() >= deadline)
+        progress.Finish(ScheduleGAStopReason::TimeLimit);
+    else
+        return false;
+
+    return true;
+}
 
-    std::vector<ScheduleIndividual> individuals(params_.IndividualsCount, firstIndividual);
+// forEach(individuals, func) runs the parallel phases. The stop conditions are checked
+// by the progress of the island, the shared progress only reports the best individual.
+template<class ForEach>
+static void RunIterations(ForEach&& forEach,
+                          ScheduleGAIsland& island,
+                          const ScheduleGAParams& params,
+                          std::size_t firstIteration,
+                          std::size_t lastIteration,
+                          ScheduleGAClock::time_point deadline,
+                          std::stop_token stopToken,
+                          ScheduleGAProgress& progress,
+                          ScheduleGAProgress* pSharedProgress = nullptr)
+{
+    auto& individuals = island.Individuals;
+    auto& randGen = island.RandomGenerator;
 
-    std::mt19937 randGen(randomDevice());
-    std::uniform_int_distribution<std::size_t> selectionBestDist(0, params_.SelectionCount - 1);
+    // the parallel phases skip the rest of individuals as soon as the stop is requested
+    const ScheduleIndividualMutator mutator(params.MutationChance);
+    const auto mutate = [&](ScheduleIndividual& individual)
+    {
+        if(!stopToken.stop_requested())
+            mutator(individual);
+    };
+    const auto evaluate = [&](ScheduleIndividual& individual)
+    {
+        if(!stopToken.stop_requested())
+            individual.Evaluate();
+    };
+
+    std::uniform_int_distribution<std::size_t> selectionBestDist(0, params.SelectionCount - 1);
     std::uniform_int_distribution<std::size_t> individualsDist(0, individuals.size() - 1);
 
-    for(std::size_t iteration = 0; iteration < params_.IterationsCount; ++iteration)
+    for(std::size_t iteration = firstIteration; iteration < lastIteration; ++iteration)
     {
+        if(ShouldStop(params, deadline, stopToken, progress))
+            return;
+
         // mutate
-        std::for_each(std::execution::par_unseq,
-                      individuals.begin(),
-                      individuals.end(),
-                      ScheduleIndividualMutator(params_.MutationChance));
+        forEach(individuals, mutate);
+        if(StopRequested(stopToken, progress))
+            return;
 
         // select best
         std::ranges::nth_element(
-            individuals, individuals.begin() + params_.SelectionCount, ScheduleIndividualLess());
-        /*std::cout << "Iteration: " << iteration << "; Best: " <<
-        std::min_element(individuals.begin(),
-                                                                                  individuals.begin()
-                                                                                  +
-                                                                                  params_.SelectionCount,
-                                                                                  ScheduleIndividualLess())->Evaluate()
-                                                                                  << '\n';*/
+            individuals, individuals.begin() + params.SelectionCount, ScheduleIndividualLess());
 
         // crossover
-        for(std::size_t i = 0; i < params_.CrossoverCount; ++i)
+        for(std::size_t i = 0; i < params.CrossoverCount; ++i)
         {
             auto& firstInd = individuals.at(selectionBestDist(randGen));
             auto& secondInd = individuals.at(individualsDist(randGen));
             firstInd.Crossover(secondInd);
         }
 
-        std::for_each(std::execution::par_unseq,
-                      individuals.begin(),
-                      individuals.end(),
-                      ScheduleIndividualEvaluator());
+        forEach(individuals, evaluate);
+        if(StopRequested(stopToken, progress))
+            return;
 
         // natural selection
         std::ranges::nth_element(
-            individuals, individuals.end() - params_.SelectionCount, ScheduleIndividualLess());
+            individuals, individuals.end() - params.SelectionCount, ScheduleIndividualLess());
         std::copy_n(individuals.begin(),
-                    params_.SelectionCount,
-                    individuals.end() - params_.SelectionCount);
+                    params.SelectionCount,
+                    individuals.end() - params.SelectionCount);
+        for(auto it = individuals.end() - params.SelectionCount; it != individuals.end(); ++it)
+            it->Reseed(randGen.Split());
+
+        const auto& best = *std::ranges::min_element(individuals, ScheduleIndividualLess());
+        progress.Update(iteration + 1, best);
+        if(pSharedProgress != nullptr)
+            pSharedProgress->Update(iteration + 1, best);
     }
+}
+
+static void Migrate(std::vector<ScheduleGAIsland>& islands)
+{
+    // ring topology: the best individual of each island replaces the worst one of the next island
+    std::vector<ScheduleIndividual> migrants;
+    migrants.reserve(islands.size());
+    for(auto&& island : islands)
+        migrants.emplace_back(*std::ranges::min_element(island.Individuals, ScheduleIndividualLess()));
 
-    auto it = std::min_element(individuals.begin(), individuals.end(), ScheduleIndividualLess());
-    return *it;
+    for(std::size_t i = 0; i < islands.size(); ++i)
+    {
+        auto& island = islands.at((i + 1) % islands.size());
+        auto& migrant = *std::ranges::max_element(island.Individuals, ScheduleIndividualLess());
+        migrant = migrants.at(i);
+        migrant.Reseed(island.RandomGenerator.Split());
+    }
+}
+
+ScheduleIndividual ScheduleGA::operator()(const ScheduleData& scheduleData) const
+{
+    ScheduleGAProgress progress;
+    return (*this)(scheduleData, progress);
+}
+
+ScheduleIndividual ScheduleGA::operator()(const ScheduleData& scheduleData,
+                                          ScheduleGAProgress& progress,
+                                          std::stop_token stopToken) const
+{
+    return Run(scheduleData, nullptr, progress, stopToken);
+}
+
+ScheduleIndividual ScheduleGA::operator()(const ScheduleData& scheduleData,
+                                          const ScheduleResult& prior,
+                                          ScheduleGAProgress& progress,
+                                          std::stop_token stopToken) const
+{
+    return Run(scheduleData, &prior, progress, stopToken);
+}
+
+ScheduleIndividual ScheduleGA::Run(const ScheduleData& scheduleData,
+                                   const ScheduleResult* pPrior,
+                                   ScheduleGAProgress& progress,
+                                   std::stop_token stopToken) const
+{
+    const auto deadline = params_.TimeLimit > 0
+                              ? ScheduleGAClock::now() + std::chrono::milliseconds(params_.TimeLimit)
+                              : ScheduleGAClock::time_point::max();
+
+    Xoshiro256 masterGenerator(params_.Seed != 0 ? params_.Seed : RandomSeed());
+    const ScheduleIndividual firstIndividual =
+        pPrior != nullptr ? ScheduleIndividual(masterGenerator.Split(),
+                                               &scheduleData,
+                                               InitializeChromosomes(scheduleData, *pPrior))
+                          : ScheduleIndividual(masterGenerator.Split(), &scheduleData);
+    firstIndividual.Evaluate();
+    progress.Update(0, firstIndividual);
+
+    std::vector<ScheduleGAIsland> islands;
+    islands.reserve(params_.IslandsCount);
+    for(int i = 0; i < params_.IslandsCount; ++i)
+    {
+        auto& island = islands.emplace_back(ScheduleGAIsland{
+            .Individuals = std::vector<ScheduleIndividual>(params_.IndividualsCount, firstIndividual),
+            .RandomGenerator = masterGenerator.Split()});
+
+        // every copy of the first individual gets its own random stream
+        for(auto&& individual : island.Individuals)
+            individual.Reseed(island.RandomGenerator.Split());
+    }
+
+    const auto forEachSeq = [](auto& items, const auto& func)
+    { std::for_each(items.begin(), items.end(), func); };
+    const auto forEachPar = [this](auto& items, const auto& func)
+    {
+        if(workerPool_ != nullptr)
+            workerPool_->ParallelFor(items.size(), [&](std::size_t i) { func(items[i]); });
+        else
+            std::for_each(std::execution::par_unseq, items.begin(), items.end(), func);
+    };
+    // Islands take the progress locks, which the unsequenced policy doesn't allow,
+    // so every island gets its own thread unless the pool runs them
+    const auto forEachIsland = [this](auto& items, const auto& func)
+    {
+        if(workerPool_ != nullptr)
+        {
+            workerPool_->ParallelFor(items.size(), [&](std::size_t i) { func(items[i]); });
+            return;
+        }
+
+        std::vector<std::exception_ptr> errors(items.size());
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(items.size());
+            for(std::size_t i = 0; i < items.size(); ++i)
+            {
+                threads.emplace_back(
+                    [&, i]
+                    {
+                        try
+                        {
+                            func(items[i]);
+                        }
+                        catch(...)
+                        {
+                            errors[i] = std::current_exception();
+                        }
+                    });
+            }
+        }
+
+        for(auto&& error : errors)
+        {
+            if(error)
+                std::rethrow_exception(error);
+        }
+    };
+
+    const std::size_t iterationsCount = params_.IterationsCount;
+    if(islands.size() == 1)
+    {
+        RunIterations(forEachPar,
+                      islands.front(),
+                      params_,
+                      0,
+                      iterationsCount,
+                      deadline,
+                      stopToken,
+                      progress);
+    }
+    else
+    {
+        // Each island evolves on its own thread and decides when to stop by its own progress,
+        // islands are synchronized only for migration. So the result of the seeded solve doesn't
+        // depend on the timing of the threads, the shared progress only reports the best one.
+        std::vector<ScheduleGAProgress> islandsProgress(islands.size());
+        for(auto&& islandProgress : islandsProgress)
+            islandProgress.Update(0, firstIndividual);
+
+        const auto islandsFinished = [&]
+        { return std::ranges::all_of(islandsProgress, &ScheduleGAProgress::Finished); };
+        const auto lowerBoundReached = [&]
+        {
+            return std::ranges::any_of(islandsProgress,
+                                       [](const ScheduleGAProgress& islandProgress)
+                                       {
+                                           return islandProgress.BestEvaluation()
+                                                  <= EVALUATION_LOWER_BOUND;
+                                       });
+        };
+        const std::size_t epochLength =
+            params_.MigrationInterval > 0 ? params_.MigrationInterval : iterationsCount;
+
+        for(std::size_t iteration = 0;
+            iteration < iterationsCount && !StopRequested(stopToken, progress)
+            && !islandsFinished() && !lowerBoundReached();
+            iteration += epochLength)
+        {
+            const std::size_t lastIteration = std::min(iteration + epochLength, iterationsCount);
+            forEachIsland(islands,
+                          [&](ScheduleGAIsland& island)
+                          {
+                              const auto i = static_cast<std::size_t>(&island - islands.data());
+                              RunIterations(forEachSeq,
+                                            island,
+                                            params_,
+                                            iteration,
+                                            lastIteration,
+                                            deadline,
+                                            stopToken,
+                                            islandsProgress.at(i),
+                                            &progress);
+                          });
+
+            if(params_.MigrationInterval > 0)
+                Migrate(islands);
+        }
+
+        // the first island wins the tie
+        const auto& best =
+            *std::ranges::min_element(islandsProgress, {}, &ScheduleGAProgress::BestEvaluation);
+        if(lowerBoundReached())
+            progress.Finish(ScheduleGAStopReason::LowerBound);
+        else if(islandsFinished())
+            progress.Finish(*best.StopReason());
+
+        progress.Finish(ScheduleGAStopReason::IterationsLimit);
+        return *best.BestIndividual();
+    }
+
+    progress.Finish(ScheduleGAStopReason::IterationsLimit);
+    return *progress.BestIndividual();
 }
 
 std::ostream& operator<<(std::ostream& os, const ScheduleGAParams& params)
@@ -100,6 +423,11 @@ std::ostream& operator<<(std::ostream& os, const ScheduleGAParams& params)
     os << "SelectionCount: " << params.IterationsCount << '\n';
     os << "CrossoverCount: " << params.CrossoverCount << '\n';
     os << "MutationChance: " << params.MutationChance << '\n';
+    os << "IslandsCount: " << params.IslandsCount << '\n';
+    os << "MigrationInterval: " << params.MigrationInterval << '\n';
+    os << "TimeLimit: " << params.TimeLimit << '\n';
+    os << "StagnationLimit: " << params.StagnationLimit << '\n';
+    os << "Seed: " << params.Seed << '\n';
     return os;
 }
 
@@ -109,3 +437,22 @@ ScheduleResult Generate(const ScheduleGA& generator, const ScheduleData& data)
     const auto bestIndividual = generator(data);
     return MakeScheduleResult(bestIndividual.Chromosomes(), data);
 }
+
+ScheduleResult Generate(const ScheduleGA& generator,
+                        const ScheduleData& data,
+                        ScheduleGAProgress& progress,
+                        std::stop_token stopToken)
+{
+    const auto bestIndividual = generator(data, progress, stopToken);
+    return MakeScheduleResult(bestIndividual.Chromosomes(), data);
+}
+
+ScheduleResult Generate(const ScheduleGA& generator,
+                        const ScheduleData& data,
+                        const ScheduleResult& prior,
+                        ScheduleGAProgress& progress,
+                        std::stop_token stopToken)
+{
+    const auto bestIndividual = generator(data, prior, progress, stopToken);
+    return MakeScheduleResult(bestIndividual.Chromosomes(), data);
+}
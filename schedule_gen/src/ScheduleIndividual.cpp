@@ -3,11 +3,19 @@
 #include "ScheduleData.h"
 
 
-ScheduleIndividual::ScheduleIndividual(std::random_device& randomDevice, const ScheduleData* pData)
+ScheduleIndividual::ScheduleIndividual(Xoshiro256 randomGenerator, const ScheduleData* pData)
+    : ScheduleIndividual(randomGenerator, pData, InitializeChromosomes(*pData))
+{
+}
+
+ScheduleIndividual::ScheduleIndividual(Xoshiro256 randomGenerator,
+                                       const ScheduleData* pData,
+                                       ScheduleChromosomes chromosomes)
     : pData_(pData)
     , evaluatedValue_(NOT_EVALUATED)
-    , chromosomes_(InitializeChromosomes(*pData))
-    , randomGenerator_(randomDevice())
+    , chromosomes_(std::move(chromosomes))
+    , evaluator_(chromosomes_, *pData)
+    , randomGenerator_(randomGenerator)
 {
     assert(pData != nullptr);
 }
@@ -16,12 +24,14 @@ void ScheduleIndividual::swap(ScheduleIndividual& other) noexcept
 {
     std::swap(evaluatedValue_, other.evaluatedValue_);
     std::swap(chromosomes_, other.chromosomes_);
+    std::swap(evaluator_, other.evaluator_);
 }
 
 ScheduleIndividual::ScheduleIndividual(const ScheduleIndividual& other)
     : pData_(other.pData_)
     , evaluatedValue_(other.evaluatedValue_)
     , chromosomes_(other.chromosomes_)
+    , evaluator_(other.evaluator_)
     , randomGenerator_(other.randomGenerator_)
 {
 }
@@ -30,6 +40,7 @@ ScheduleIndividual& ScheduleIndividual::operator=(const ScheduleIndividual& othe
 {
     ScheduleIndividual tmp(other);
     tmp.swap(*this);
+    randomGenerator_ = other.randomGenerator_;
     return *this;
 }
 
@@ -37,6 +48,7 @@ ScheduleIndividual::ScheduleIndividual(ScheduleIndividual&& other) noexcept
     : pData_(other.pData_)
     , evaluatedValue_(other.evaluatedValue_)
     , chromosomes_(std::move(other.chromosomes_))
+    , evaluator_(std::move(other.evaluator_))
     , randomGenerator_(other.randomGenerator_)
 {
 }
@@ -56,7 +68,7 @@ std::size_t ScheduleIndividual::MutationProbability() const
 void ScheduleIndividual::Mutate()
 {
     if(::Mutate(chromosomes_, *pData_, randomGenerator_))
-        evaluatedValue_ = NOT_EVALUATED;
+        UpdateEvaluation();
 }
 
 std::size_t ScheduleIndividual::Evaluate() const
@@ -64,7 +76,7 @@ std::size_t ScheduleIndividual::Evaluate() const
     if(evaluatedValue_ != NOT_EVALUATED)
         return evaluatedValue_;
 
-    evaluatedValue_ = ::Evaluate(chromosomes_, *pData_);
+    evaluatedValue_ = evaluator_.Evaluate(chromosomes_);
     return evaluatedValue_;
 }
 
@@ -75,19 +87,26 @@ void ScheduleIndividual::Crossover(ScheduleIndividual& other)
     const auto requestIndex = requestsDist(randomGenerator_);
     if(ReadyToCrossover(chromosomes_, other.chromosomes_, *pData_, requestIndex))
     {
-        evaluatedValue_ = NOT_EVALUATED;
-        other.evaluatedValue_ = NOT_EVALUATED;
         ::Crossover(chromosomes_, other.chromosomes_, *pData_, requestIndex);
+        UpdateEvaluation();
+        other.UpdateEvaluation();
     }
 }
 
+void ScheduleIndividual::UpdateEvaluation()
+{
+    evaluator_.Update(chromosomes_);
+    chromosomes_.ClearChanges();
+    evaluatedValue_ = NOT_EVALUATED;
+}
+
 void swap(ScheduleIndividual& lhs, ScheduleIndividual& rhs) { lhs.swap(rhs); }
 
 void Print(const ScheduleIndividual& individ, const ScheduleData& data)
 {
     const auto& requests = data.SubjectRequests();
-    const auto& lessons = individ.Chromosomes().Lessons();
-    const auto& classrooms = individ.Chromosomes().Classrooms();
+    const auto& chromosomes = individ.Chromosomes();
+    const auto& lessons = chromosomes.Lessons();
 
     for(std::size_t l = 0; l < MAX_LESSONS_COUNT; ++l)
     {
@@ -105,7 +124,8 @@ void Print(const ScheduleIndividual& individ, const ScheduleData& data)
                 const std::size_t r = std::distance(std::begin(lessons), it);
                 const auto& request = requests.at(r);
                 std::cout << "[s:" << request.ID() << ", p:" << request.Professor() << ", c:("
-                          << classrooms.at(r).Building << ", " << classrooms.at(r).Classroom
+                          << chromosomes.Classroom(r).Building << ", "
+                          << chromosomes.Classroom(r).Classroom
                           << "), g: {";
 
                 for(auto&& g : request.Groups())
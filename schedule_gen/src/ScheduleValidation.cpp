@@ -46,28 +46,38 @@ std::vector<OverlappedProfessor> FindOverlappedProfessors(const ScheduleData& da
                                                           const ScheduleResult& result)
 {
     std::vector<OverlappedProfessor> overlappedProfessors;
+    // [professor index, subject request ID] pairs, dense indexes are ordered as professors IDs
+    std::vector<std::pair<std::size_t, std::size_t>> professorsAndSubjects;
     for(std::size_t l = 0; l < MAX_LESSONS_COUNT; ++l)
     {
-        std::map<std::size_t, std::vector<std::size_t>> professorsAndSubjects;
+        professorsAndSubjects.clear();
         const auto lessonsRange = result.at(l);
         for(auto&& item : lessonsRange)
         {
             const auto& request = data.SubjectRequestAtID(item.SubjectRequestID);
-            professorsAndSubjects[request.Professor()].emplace_back(item.SubjectRequestID);
+            professorsAndSubjects.emplace_back(data.IndexOfProfessor(request.Professor()),
+                                               item.SubjectRequestID);
         }
 
-        for(auto& [professor, subjects] : professorsAndSubjects)
+        std::ranges::sort(professorsAndSubjects);
+        for(auto first = professorsAndSubjects.begin(); first != professorsAndSubjects.end();)
         {
-            if(subjects.size() > 1)
+            const auto last = std::find_if(first,
+                                           professorsAndSubjects.end(),
+                                           [&](auto&& p) { return p.first != first->first; });
+            if(std::distance(first, last) > 1)
             {
-                std::ranges::sort(subjects);
-
                 OverlappedProfessor overlappedProfessor;
                 overlappedProfessor.Address = l;
-                overlappedProfessor.Professor = professor;
-                overlappedProfessor.SubjectRequestsIDs = std::move(subjects);
+                overlappedProfessor.Professor = data.ProfessorID(first->first);
+                std::transform(first,
+                               last,
+                               std::back_inserter(overlappedProfessor.SubjectRequestsIDs),
+                               [](auto&& p) { return p.second; });
                 overlappedProfessors.emplace_back(std::move(overlappedProfessor));
             }
+
+            first = last;
         }
     }
 
@@ -0,0 +1,90 @@
+#include "ScheduleWorkerPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+
+ScheduleWorkerPool::ScheduleWorkerPool(std::size_t threadsCount)
+{
+    if(threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    threads_.reserve(threadsCount);
+    for(std::size_t i = 0; i < threadsCount; ++i)
+        threads_.emplace_back([this](std::stop_token stopToken) { WorkerLoop(stopToken); });
+}
+
+void ScheduleWorkerPool::ParallelFor(std::size_t count,
+                                     const std::function<void(std::size_t)>& func)
+{
+    struct Loop
+    {
+        std::atomic<std::size_t> NextIndex = 0;
+        std::mutex Mutex;
+        std::condition_variable FinishedWorker;
+        std::size_t RunningWorkers = 0;
+        std::exception_ptr Error;
+    } loop;
+
+    // every worker takes the next index until they are over, so the slow calls are balanced
+    const std::size_t workersCount = std::min(count, threads_.size());
+    loop.RunningWorkers = workersCount;
+    for(std::size_t w = 0; w < workersCount; ++w)
+    {
+        Post(
+            [&loop, &func, count]
+            {
+                try
+                {
+                    for(std::size_t i = loop.NextIndex++; i < count; i = loop.NextIndex++)
+                        func(i);
+                }
+                catch(...)
+                {
+                    loop.NextIndex = count;
+                    std::lock_guard lock(loop.Mutex);
+                    if(!loop.Error)
+                        loop.Error = std::current_exception();
+                }
+
+                std::lock_guard lock(loop.Mutex);
+                if(--loop.RunningWorkers == 0)
+                    loop.FinishedWorker.notify_all();
+            });
+    }
+
+    std::unique_lock lock(loop.Mutex);
+    loop.FinishedWorker.wait(lock, [&] { return loop.RunningWorkers == 0; });
+    if(loop.Error)
+        std::rethrow_exception(loop.Error);
+}
+
+void ScheduleWorkerPool::Post(std::function<void()> task)
+{
+    {
+        std::lock_guard lock(mutex_);
+        tasks_.emplace_back(std::move(task));
+    }
+
+    tasksAdded_.notify_one();
+}
+
+void ScheduleWorkerPool::WorkerLoop(std::stop_token stopToken)
+{
+    while(true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex_);
+            if(!tasksAdded_.wait(lock, stopToken, [&] { return !tasks_.empty(); }))
+                return;
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        task();
+    }
+}
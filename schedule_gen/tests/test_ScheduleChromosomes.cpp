@@ -3,6 +3,11 @@
 #include "ScheduleGA.h"
 #include "ScheduleUtils.h"
 
+#include <numeric>
+#include <random>
+#include <unordered_set>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <catch2/catch.hpp>
 
 
@@ -89,6 +94,38 @@ TEST_CASE("No ovelaps by classrooms", "[chromosomes][initialization]")
         REQUIRE(sut.Lesson(r - 1) != sut.Lesson(r));
 }
 
+TEST_CASE("Warm start keeps the valid prior placements", "[chromosomes][initialization]")
+{
+    // [id, professor, complexity, groups, lessons, classrooms]
+    const ScheduleData data{{SubjectRequest{0, 1, 1, {1}, {}, {{0, 1}, {0, 2}}},
+                             SubjectRequest{1, 2, 1, {2}, {}, {{0, 1}}},
+                             SubjectRequest{2, 3, 1, {3}, {5, 6}, {{0, 3}}},
+                             SubjectRequest{3, 1, 1, {4}, {}, {{0, 4}}},
+                             SubjectRequest{4, 5, 1, {5}, {}, {}}}};
+
+    // [address, subject request ID, classroom]
+    const ScheduleResult prior{{ScheduleItem{7, 0, 2},
+                                ScheduleItem{8, 1, 1},
+                                // the lesson is not allowed anymore
+                                ScheduleItem{10, 2, 3},
+                                // the professor is busy with the request 0
+                                ScheduleItem{7, 3, 4},
+                                // the request is removed
+                                ScheduleItem{3, 99, 1}}};
+
+    const ScheduleChromosomes sut = InitializeChromosomes(data, prior);
+    REQUIRE(sut.Lesson(0) == 7);
+    REQUIRE(sut.Classroom(0) == ClassroomAddress{0, 2});
+    REQUIRE(sut.Lesson(1) == 8);
+    REQUIRE(sut.Classroom(1) == ClassroomAddress{0, 1});
+
+    REQUIRE((sut.Lesson(2) == 5 || sut.Lesson(2) == 6));
+    REQUIRE(sut.Lesson(3) != 7);
+    REQUIRE(sut.Lesson(3) != NO_LESSON);
+    REQUIRE(sut.Lesson(4) != NO_LESSON);
+    REQUIRE(sut.Changes().empty());
+}
+
 TEST_CASE("Check for groups intersection performs", "[chromosomes][checks][intersections]")
 {
     // [id, professor, complexity, groups, lessons, classrooms]
@@ -97,7 +134,8 @@ TEST_CASE("Check for groups intersection performs", "[chromosomes][checks][inter
                              SubjectRequest{2, 3, 1, {6, 7, 8}, {}, {{0, 3}}},
                              SubjectRequest{3, 4, 1, {9, 10, 11}, {}, {{0, 4}}},
                              SubjectRequest{4, 5, 1, {12, 13, 14}, {}, {{0, 5}}}}};
-    const ScheduleChromosomes sut{{0, 1, 2, 3, 4}, {{0, 1}, {0, 2}, {0, 3}, {0, 1}, {0, 2}}};
+    const ScheduleChromosomes sut{
+        data, {0, 1, 2, 3, 4}, {{0, 1}, {0, 2}, {0, 3}, {0, 4}, {0, 5}}};
 
     REQUIRE(sut.GroupsOrProfessorsIntersects(data, 1, 0));
     REQUIRE(sut.GroupsOrProfessorsOrClassroomsIntersects(data, 1, 0));
@@ -114,7 +152,8 @@ TEST_CASE("Check for professors intersection performs", "[chromosomes][checks][i
                              SubjectRequest{2, 3, 1, {3}, {}, {{0, 3}}},
                              SubjectRequest{3, 4, 1, {4}, {}, {{0, 4}}},
                              SubjectRequest{4, 5, 1, {5}, {}, {{0, 5}}}}};
-    const ScheduleChromosomes sut{{0, 1, 2, 3, 4}, {{0, 1}, {0, 2}, {0, 3}, {0, 1}, {0, 2}}};
+    const ScheduleChromosomes sut{
+        data, {0, 1, 2, 3, 4}, {{0, 1}, {0, 2}, {0, 3}, {0, 4}, {0, 5}}};
 
     REQUIRE(sut.GroupsOrProfessorsIntersects(data, 1, 0));
     REQUIRE(sut.GroupsOrProfessorsOrClassroomsIntersects(data, 1, 0));
@@ -131,7 +170,8 @@ TEST_CASE("Check for classrooms intersection performs", "[chromosomes][checks][i
                              SubjectRequest{2, 3, 1, {3}, {}, {{0, 1}, {0, 2}, {0, 3}}},
                              SubjectRequest{3, 4, 1, {4}, {}, {{0, 1}, {0, 2}, {0, 3}}},
                              SubjectRequest{4, 5, 1, {5}, {}, {{0, 1}, {0, 2}, {0, 3}}}}};
-    const ScheduleChromosomes sut{{0, 1, 2, 3, 4}, {{0, 1}, {0, 2}, {0, 3}, {0, 1}, {0, 2}}};
+    const ScheduleChromosomes sut{
+        data, {0, 1, 2, 3, 4}, {{0, 1}, {0, 2}, {0, 3}, {0, 1}, {0, 2}}};
 
     REQUIRE_FALSE(sut.GroupsOrProfessorsIntersects(data, 3, 0));
     REQUIRE(sut.GroupsOrProfessorsOrClassroomsIntersects(data, 3, 0));
@@ -140,6 +180,39 @@ TEST_CASE("Check for classrooms intersection performs", "[chromosomes][checks][i
     REQUIRE_FALSE(sut.GroupsOrProfessorsOrClassroomsIntersects(data, 1, 0));
 }
 
+TEST_CASE("Intersections checks follow the genes changes", "[chromosomes][checks][intersections]")
+{
+    // [id, professor, complexity, groups, lessons, classrooms]
+    const ScheduleData data{{SubjectRequest{0, 1, 1, {1}, {}, {{0, 1}, {0, 2}}},
+                             SubjectRequest{1, 1, 1, {2}, {}, {{0, 1}, {0, 2}}},
+                             SubjectRequest{2, 2, 1, {1}, {}, {{0, 1}, {0, 2}}},
+                             SubjectRequest{3, 3, 1, {3}, {}, {{0, 3}}},
+                             SubjectRequest{4, 4, 1, {4}, {}, {{0, 3}}}}};
+
+    // requests 0 and 1 share the professor and are placed at the same lesson
+    ScheduleChromosomes sut{
+        data, {0, 0, NO_LESSON, NO_LESSON, 5}, {{0, 1}, {0, 2}, {0, 1}, {0, 3}, {0, 3}}};
+
+    REQUIRE(sut.GroupsOrProfessorsIntersects(data, 2, 0));
+    REQUIRE(sut.ClassroomsIntersects(0, ClassroomAddress{.Building = 0, .Classroom = 2}));
+
+    sut.SetLesson(0, 1);
+    REQUIRE_FALSE(sut.GroupsOrProfessorsIntersects(data, 2, 0));
+    REQUIRE(sut.GroupsOrProfessorsIntersects(data, 1, 1));
+    REQUIRE(sut.ClassroomsIntersects(1, ClassroomAddress{.Building = 0, .Classroom = 1}));
+    REQUIRE_FALSE(sut.ClassroomsIntersects(0, ClassroomAddress{.Building = 0, .Classroom = 1}));
+
+    sut.SetClassroom(1, ClassroomAddress{.Building = 0, .Classroom = 1});
+    REQUIRE_FALSE(sut.ClassroomsIntersects(0, ClassroomAddress{.Building = 0, .Classroom = 2}));
+    REQUIRE(sut.GroupsOrProfessorsOrClassroomsIntersects(data, 2, 0));
+
+    // the only classroom of the request is occupied as a resource regardless of the genes
+    REQUIRE(sut.GroupsOrProfessorsIntersects(data, 3, 5));
+    sut.SetLesson(4, NO_LESSON);
+    REQUIRE_FALSE(sut.GroupsOrProfessorsIntersects(data, 3, 5));
+    REQUIRE(sut.GroupsOrProfessorsIntersects(data, 3, NO_LESSON));
+}
+
 TEST_CASE("Check if chromosomes ready for crossover", "[chromosomes][checks][crossover]")
 {
     // [id, professor, complexity, groups, lessons, classrooms]
@@ -149,8 +222,10 @@ TEST_CASE("Check if chromosomes ready for crossover", "[chromosomes][checks][cro
                              SubjectRequest{3, 4, 1, {7, 8, 9}, {}, {{0, 1}, {0, 2}, {0, 3}}},
                              SubjectRequest{4, 5, 1, {10}, {}, {{0, 1}, {0, 2}, {0, 3}}}}};
 
-    ScheduleChromosomes sut1{{0, 1, 2, 3, 4}, {{0, 3}, {0, 2}, {0, 1}, {0, 3}, {0, 2}}};
-    ScheduleChromosomes sut2{{4, 3, 2, 1, 0}, {{0, 1}, {0, 2}, {0, 3}, {0, 2}, {0, 2}}};
+    ScheduleChromosomes sut1{
+        data, {0, 1, 2, 3, 4}, {{0, 3}, {0, 2}, {0, 1}, {0, 3}, {0, 2}}};
+    ScheduleChromosomes sut2{
+        data, {4, 3, 2, 1, 0}, {{0, 1}, {0, 2}, {0, 3}, {0, 2}, {0, 2}}};
 
     REQUIRE(ReadyToCrossover(sut1, sut2, data, 0));
     REQUIRE_FALSE(ReadyToCrossover(sut1, sut2, data, 1));
@@ -168,8 +243,10 @@ TEST_CASE("Crossover works", "[chromosomes][crossover]")
                              SubjectRequest{3, 4, 1, {7, 8, 9}, {}, {{0, 1}, {0, 2}, {0, 3}}},
                              SubjectRequest{4, 5, 1, {10}, {}, {{0, 1}, {0, 2}, {0, 3}}}}};
 
-    ScheduleChromosomes first{{0, 1, 2, 3, 4}, {{0, 3}, {0, 2}, {0, 1}, {0, 3}, {0, 2}}};
-    ScheduleChromosomes second{{4, 3, 2, 1, 0}, {{0, 1}, {0, 2}, {0, 3}, {0, 1}, {0, 2}}};
+    ScheduleChromosomes first{
+        data, {0, 1, 2, 3, 4}, {{0, 3}, {0, 2}, {0, 1}, {0, 3}, {0, 2}}};
+    ScheduleChromosomes second{
+        data, {4, 3, 2, 1, 0}, {{0, 1}, {0, 2}, {0, 3}, {0, 1}, {0, 2}}};
 
     Crossover(first, second, data, 0);
     REQUIRE(first.Lesson(0) == 4);
@@ -188,8 +265,8 @@ TEST_CASE("MakeScheduleResult works correctly", "[chromosomes][conversions]")
                              SubjectRequest{3, 4, 1, {7, 8, 9}, {}, {{0, 1}, {0, 2}, {0, 3}}},
                              SubjectRequest{4, 5, 1, {10}, {}, {{0, 1}, {0, 2}, {0, 3}}}}};
 
-    const ScheduleChromosomes chromosomes{{0, 4, 3, 2, 1},
-                                          {{0, 1}, {0, 1}, {0, 3}, {0, 2}, {0, 3}}};
+    const ScheduleChromosomes chromosomes{
+        data, {0, 4, 3, 2, 1}, {{0, 1}, {0, 1}, {0, 3}, {0, 2}, {0, 3}}};
 
     const ScheduleResult scheduleResult = MakeScheduleResult(chromosomes, data);
     REQUIRE(contains(scheduleResult.items(),
@@ -205,6 +282,192 @@ TEST_CASE("MakeScheduleResult works correctly", "[chromosomes][conversions]")
 }
 
 
+TEST_CASE("Chromosomes genes encoding", "[chromosomes][encoding]")
+{
+    // [id, professor, complexity, groups, lessons, classrooms]
+    const ScheduleData data{{SubjectRequest{0, 1, 1, {0}, {}, {{0, 1}, {0, 2}, {1, 3}}},
+                             SubjectRequest{1, 2, 1, {1}, {}, {}}}};
+
+    ScheduleChromosomes sut{data};
+    REQUIRE(sut.Lesson(0) == NO_LESSON);
+    REQUIRE(sut.Classroom(0) == ClassroomAddress::NoClassroom());
+    REQUIRE(sut.UnassignedLessonsCount() == 2);
+    REQUIRE(sut.UnassignedClassroomsCount() == 2);
+
+    sut.SetLesson(0, MAX_LESSONS_COUNT - 1);
+    sut.SetClassroom(0, ClassroomAddress{.Building = 1, .Classroom = 3});
+    sut.SetLesson(1, 5);
+    sut.SetClassroom(1, ClassroomAddress::Any());
+
+    REQUIRE(sut.Lessons() == std::vector<LessonGene>{MAX_LESSONS_COUNT - 1, 5});
+    REQUIRE(sut.Classrooms() == std::vector<ClassroomGene>{2, ANY_CLASSROOM_GENE});
+    REQUIRE(sut.Lesson(0) == MAX_LESSONS_COUNT - 1);
+    REQUIRE(sut.Classroom(0) == ClassroomAddress{.Building = 1, .Classroom = 3});
+    REQUIRE(sut.Classroom(1) == ClassroomAddress::Any());
+    REQUIRE(sut.UnassignedLessonsCount() == 0);
+    REQUIRE(sut.UnassignedClassroomsCount() == 0);
+
+    REQUIRE_THROWS_AS(sut.SetLesson(0, MAX_LESSONS_COUNT), std::out_of_range);
+    REQUIRE_THROWS_AS(sut.SetClassroom(0, ClassroomAddress{.Building = 0, .Classroom = 3}),
+                      std::invalid_argument);
+}
+
+// straightforward sort-based evaluation, the reference for the Evaluate() kernel
+static std::size_t ReferenceEvaluate(const ScheduleChromosomes& scheduleChromosomes,
+                                     const ScheduleData& scheduleData)
+{
+    std::size_t maxDayComplexity = 0;
+    std::size_t maxLessonsGapsForGroups = 0;
+    std::size_t maxLessonsGapsForProfessors = 0;
+    std::size_t maxBuildingsChangesForGroups = 0;
+    std::size_t maxBuildingsChangesForProfessors = 0;
+
+    auto calculateGap = [](auto&& lhs, auto&& rhs) { return lhs.first - rhs.first - 1; };
+
+    auto buildingsChanged = [&](auto&& lhs, auto&& rhs) -> bool
+    {
+        const auto lhsBuilding = scheduleChromosomes.Classroom(lhs.second).Building;
+        const auto rhsBuilding = scheduleChromosomes.Classroom(rhs.second).Building;
+        return !(lhsBuilding == rhsBuilding || lhs.first - rhs.first > 1
+                 || lhsBuilding == NO_BUILDING || rhsBuilding == NO_BUILDING);
+    };
+
+    const auto& requests = scheduleData.SubjectRequests();
+    auto evaluateEntity = [&](const std::unordered_set<std::size_t>& entityRequests,
+                              std::size_t& maxGaps,
+                              std::size_t& maxBuildingsChanges,
+                              std::size_t* pMaxComplexity)
+    {
+        std::vector<std::pair<std::size_t, std::size_t>> lessons;
+        for(std::size_t r : entityRequests)
+        {
+            if(scheduleChromosomes.Lesson(r) != NO_LESSON)
+                lessons.emplace_back(scheduleChromosomes.Lesson(r), r);
+        }
+
+        std::ranges::sort(lessons);
+        for(auto first = lessons.begin(); first != lessons.end();)
+        {
+            const std::size_t day = first->first / MAX_LESSONS_PER_DAY;
+            const auto last = std::find_if(first,
+                                           lessons.end(),
+                                           [&](auto&& p)
+                                           { return p.first / MAX_LESSONS_PER_DAY != day; });
+
+            maxGaps = std::max(maxGaps,
+                               std::inner_product(std::next(first),
+                                                  last,
+                                                  first,
+                                                  std::size_t{0},
+                                                  std::plus<>{},
+                                                  calculateGap));
+            maxBuildingsChanges = std::max(maxBuildingsChanges,
+                                           std::inner_product(std::next(first),
+                                                              last,
+                                                              first,
+                                                              std::size_t{0},
+                                                              std::plus<>{},
+                                                              buildingsChanged));
+            if(pMaxComplexity != nullptr)
+            {
+                *pMaxComplexity = std::max(
+                    *pMaxComplexity,
+                    std::accumulate(first,
+                                    last,
+                                    std::size_t{0},
+                                    [&](auto accum, auto&& p) {
+                                        return accum
+                                               + (p.first % MAX_LESSONS_PER_DAY)
+                                                     * requests.at(p.second).Complexity();
+                                    }));
+            }
+
+            first = last;
+        }
+    };
+
+    for(auto&& [professor, professorRequests] : scheduleData.Professors())
+    {
+        evaluateEntity(professorRequests,
+                       maxLessonsGapsForProfessors,
+                       maxBuildingsChangesForProfessors,
+                       nullptr);
+    }
+
+    for(auto&& [group, groupRequests] : scheduleData.Groups())
+    {
+        evaluateEntity(
+            groupRequests, maxLessonsGapsForGroups, maxBuildingsChangesForGroups, &maxDayComplexity);
+    }
+
+    return maxLessonsGapsForGroups * 3 + maxLessonsGapsForProfessors * 2 + maxDayComplexity * 4
+           + maxBuildingsChangesForProfessors * 64 + maxBuildingsChangesForGroups * 64
+           + scheduleChromosomes.UnassignedLessonsCount() * 128
+           + scheduleChromosomes.UnassignedClassroomsCount() * 128;
+}
+
+static ScheduleData MakeEvaluationData(std::size_t requestsCount)
+{
+    std::vector<SubjectRequest> requests;
+    for(std::size_t r = 0; r < requestsCount; ++r)
+    {
+        // [id, professor, complexity, groups, lessons, classrooms]
+        requests.emplace_back(r,
+                              r % 17,
+                              r % MAX_COMPLEXITY + 1,
+                              std::vector<std::size_t>{r % 11, 11 + r % 5},
+                              std::vector<std::size_t>{},
+                              std::vector<ClassroomAddress>{{r % 3, 1}, {r % 3 + 1, 2}, {4, r % 6}});
+    }
+
+    return ScheduleData{std::move(requests)};
+}
+
+static ScheduleChromosomes MakeRandomChromosomes(const ScheduleData& data, std::mt19937& randGen)
+{
+    std::uniform_int_distribution<std::size_t> lessonsDistrib(0, MAX_LESSONS_COUNT);
+    std::uniform_int_distribution<std::size_t> classroomsDistrib(0, 4);
+
+    ScheduleChromosomes chromosomes(data);
+    for(std::size_t r = 0; r < data.SubjectRequests().size(); ++r)
+    {
+        const std::size_t lesson = lessonsDistrib(randGen);
+        chromosomes.SetLesson(r, lesson == MAX_LESSONS_COUNT ? NO_LESSON : lesson);
+
+        const auto& classrooms = data.SubjectRequests().at(r).Classrooms();
+        const std::size_t classroom = classroomsDistrib(randGen);
+        if(classroom < classrooms.size())
+            chromosomes.SetClassroom(r, classrooms.at(classroom));
+        else if(classroom == classrooms.size())
+            chromosomes.SetClassroom(r, ClassroomAddress::Any());
+    }
+
+    return chromosomes;
+}
+
+TEST_CASE("Evaluate equals to the sort-based evaluation", "[chromosomes][evaluation]")
+{
+    std::mt19937 randGen(GENERATE(1u, 2u, 3u));
+    for(std::size_t requestsCount : {10, 60, 300})
+    {
+        const ScheduleData data = MakeEvaluationData(requestsCount);
+        for(std::size_t i = 0; i < 20; ++i)
+        {
+            const ScheduleChromosomes chromosomes = MakeRandomChromosomes(data, randGen);
+            REQUIRE(Evaluate(chromosomes, data) == ReferenceEvaluate(chromosomes, data));
+        }
+    }
+}
+
+TEST_CASE("Evaluate benchmark", "[.][benchmark][evaluation]")
+{
+    const ScheduleData data = MakeEvaluationData(500);
+    const ScheduleChromosomes chromosomes = InitializeChromosomes(data);
+
+    BENCHMARK("Bitmaps evaluation") { return Evaluate(chromosomes, data); };
+    BENCHMARK("Sort-based evaluation") { return ReferenceEvaluate(chromosomes, data); };
+}
+
 struct OneValueGenerator
 {
     using result_type = std::size_t;
@@ -263,9 +526,10 @@ TEST_CASE("Mutate lessons", "[chromosomes_mutator][lessons]")
                              SubjectRequest{1, 1, 1, {1}, {}, {{0, 2}}},
                              SubjectRequest{2, 3, 1, {0, 2}, {}, {{0, 3}}},
                              SubjectRequest{3, 4, 1, {3}, {}, {{0, 1}, {0, 4}}},
-                             SubjectRequest{4, 3, 1, {3}, {0, 1, 2, 3}, {{0, 2}}}}};
+                             SubjectRequest{4, 3, 1, {3}, {0, 1, 2, 3}, {{0, 2}, {0, 5}}}}};
 
-    ScheduleChromosomes chromosomes{{0, 1, 2, 3, 4}, {{0, 1}, {0, 2}, {0, 3}, {0, 1}, {0, 5}}};
+    ScheduleChromosomes chromosomes{
+        data, {0, 1, 2, 3, 4}, {{0, 1}, {0, 2}, {0, 3}, {0, 1}, {0, 5}}};
 
     SECTION("Do not mutate if professors intersects")
     {
@@ -314,8 +578,8 @@ TEST_CASE("Mutate lessons block", "[chromosomes_mutator][lessons][blocks]")
                              SubjectRequest{5, 5, 1, {4}, {}, {{0, 5}}}},
                             {{SubjectsBlock{{0, 1}, {0, 1, 2, 3, 4}}}}};
 
-    ScheduleChromosomes chromosomes{{0, 1, 2, 3, 4, 5},
-                                    {{0, 1}, {0, 2}, {0, 3}, {0, 1}, {0, 2}, {0, 5}}};
+    ScheduleChromosomes chromosomes{
+        data, {0, 1, 2, 3, 4, 5}, {{0, 1}, {0, 2}, {0, 3}, {0, 1}, {0, 2}, {0, 5}}};
 
     SECTION("Do not mutate if professors intersects")
     {
@@ -361,7 +625,8 @@ TEST_CASE("Mutate classrooms", "[chromosomes_mutator][classrooms]")
                              SubjectRequest{2, 3, 1, {2}, {}, {{0, 1}, {0, 2}, {0, 3}}},
                              SubjectRequest{3, 4, 1, {3}, {}, {{0, 1}, {0, 3}, {0, 4}}}}};
 
-    ScheduleChromosomes chromosomes{{0, 0, 1, 1}, {{0, 1}, {0, 2}, {0, 1}, {0, 3}}};
+    ScheduleChromosomes chromosomes{
+        data, {0, 0, 1, 1}, {{0, 1}, {0, 2}, {0, 1}, {0, 3}}};
 
     SECTION("Do not mutate if classrooms itersects")
     {
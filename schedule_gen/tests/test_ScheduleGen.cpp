@@ -1,10 +1,17 @@
 #include "ScheduleCommon.h"
 #include "ScheduleData.h"
+#include "ScheduleGA.h"
+#include "ScheduleIndividual.h"
 #include "ScheduleResult.h"
 #include "ScheduleUtils.h"
+#include "ScheduleWorkerPool.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <catch2/catch.hpp>
+#include <stop_token>
+#include <thread>
 
 
 TEST_CASE("Search by subject id performs correctly", "[schedule_data]")
@@ -37,6 +44,100 @@ TEST_CASE("Search by subject id performs correctly", "[schedule_data]")
     }
 }
 
+TEST_CASE("Professors and groups are interned to dense indexes", "[schedule_data]")
+{
+    // [id, professor, complexity, groups, lessons, classrooms]
+    const ScheduleData sut{{SubjectRequest{0, 10, 1, {3, 7}, {}, {}},
+                            SubjectRequest{1, 5, 1, {3}, {}, {}},
+                            SubjectRequest{2, 10, 2, {9}, {}, {}}}};
+
+    REQUIRE(sut.ProfessorsCount() == 2);
+    REQUIRE(sut.ProfessorID(0) == 5);
+    REQUIRE(sut.ProfessorID(1) == 10);
+    REQUIRE(sut.IndexOfProfessor(10) == 1);
+    REQUIRE(std::ranges::equal(sut.ProfessorRequests(1), std::vector<std::size_t>{0, 2}));
+    REQUIRE_THROWS_AS(sut.IndexOfProfessor(1), std::out_of_range);
+
+    REQUIRE(sut.GroupsCount() == 3);
+    REQUIRE(sut.GroupID(0) == 3);
+    REQUIRE(sut.IndexOfGroup(9) == 2);
+    REQUIRE(std::ranges::equal(sut.GroupRequests(0), std::vector<std::size_t>{0, 1}));
+    REQUIRE(std::ranges::equal(sut.GroupRequests(2), std::vector<std::size_t>{2}));
+    REQUIRE_THROWS_AS(sut.IndexOfGroup(4), std::out_of_range);
+
+    REQUIRE(sut.Professors().size() == 2);
+    REQUIRE(sut.Professors().at(10) == std::unordered_set<std::size_t>{0, 2});
+    REQUIRE(sut.Groups().size() == 3);
+    REQUIRE(sut.Groups().at(3) == std::unordered_set<std::size_t>{0, 1});
+}
+
+TEST_CASE("Intersecting requests are found by the conflict graph", "[schedule_data]")
+{
+    // [id, professor, complexity, groups, lessons, classrooms]
+    const ScheduleData sut{{SubjectRequest{0, 1, 1, {0}, {}, {}},
+                            SubjectRequest{1, 1, 1, {1}, {}, {}},
+                            SubjectRequest{2, 2, 1, {0, 2}, {}, {}},
+                            SubjectRequest{3, 3, 1, {3}, {}, {{0, 1}}},
+                            SubjectRequest{4, 4, 1, {4}, {}, {{0, 1}}},
+                            SubjectRequest{5, 5, 1, {5}, {}, {}}}};
+
+    REQUIRE(FindIntersectingRequests(sut, {0}) == std::vector<std::size_t>{0, 1, 2});
+    REQUIRE(FindIntersectingRequests(sut, {3}) == std::vector<std::size_t>{3, 4});
+    REQUIRE(FindIntersectingRequests(sut, {1, 5}) == std::vector<std::size_t>{0, 1, 5});
+    REQUIRE(FindIntersectingRequests(sut, {}).empty());
+}
+
+TEST_CASE("Intersections of the edited requests are updated from the previous data",
+          "[schedule_data]")
+{
+    // [id, professor, complexity, groups, lessons, classrooms]
+    const ScheduleData previous{{SubjectRequest{0, 1, 1, {0}, {}, {}},
+                                 SubjectRequest{2, 1, 1, {1}, {}, {}},
+                                 SubjectRequest{4, 2, 1, {0, 2}, {}, {}},
+                                 SubjectRequest{6, 3, 1, {3}, {}, {{0, 1}}},
+                                 SubjectRequest{8, 4, 1, {4}, {}, {{0, 1}}}}};
+
+    // request 2 is removed, 4 is modified and 5 is added
+    const std::vector<SubjectRequest> requests{SubjectRequest{0, 1, 1, {0}, {}, {}},
+                                               SubjectRequest{4, 4, 1, {3}, {}, {}},
+                                               SubjectRequest{5, 3, 1, {5}, {}, {}},
+                                               SubjectRequest{6, 3, 1, {3}, {}, {{0, 1}}},
+                                               SubjectRequest{8, 4, 1, {4}, {}, {{0, 1}}}};
+
+    const ScheduleData sut(requests, {}, UpdateIntersectionsMatrix(requests, previous, {4, 5}));
+    const ScheduleData expected(requests);
+    for(std::size_t i = 0; i < requests.size(); ++i)
+    {
+        for(std::size_t j = 0; j < requests.size(); ++j)
+            REQUIRE(sut.Intersects(i, j) == expected.Intersects(i, j));
+    }
+}
+
+TEST_CASE("Block first lessons allow the next lessons of the block", "[schedule_data]")
+{
+    SECTION("Second request allowed only at the lesson after the first one")
+    {
+        // [id, professor, complexity, groups, lessons, classrooms]
+        const std::vector<SubjectRequest> requests{SubjectRequest{0, 1, 1, {0}, {0, 1, 2, 3}, {}},
+                                                   SubjectRequest{1, 1, 1, {0}, {2}, {}}};
+
+        REQUIRE(SelectBlockFirstLessons(requests, {0, 1}) == std::vector<std::size_t>{1});
+    }
+    SECTION("Block doesn't continue to the next day")
+    {
+        constexpr std::size_t lastLesson = MAX_LESSONS_PER_DAY - 1;
+        const std::vector<SubjectRequest> requests{
+            SubjectRequest{0, 1, 1, {0}, {lastLesson - 1, lastLesson}, {}},
+            SubjectRequest{1, 1, 1, {0}, {lastLesson, lastLesson + 1}, {}},
+            SubjectRequest{2, 1, 1, {0}, {lastLesson}, {}}};
+
+        REQUIRE(SelectBlockFirstLessons(requests, {0, 1})
+                == std::vector<std::size_t>{lastLesson - 1});
+        REQUIRE(SelectBlockFirstLessons(requests, {2, 1}).empty());
+        REQUIRE(SelectBlockFirstLessons(requests, {2}) == std::vector<std::size_t>{lastLesson});
+    }
+}
+
 TEST_CASE("Sorting lessons by order in day")
 {
     SECTION("Empty lessons")
@@ -61,3 +162,248 @@ TEST_CASE("Sorting lessons by order in day")
                 == std::vector<std::size_t>{0, 7, 21, 1, 8, 15, 3, 17, 5, 6});
     }
 }
+
+TEST_CASE("Incremental evaluation equals to the full one", "[schedule_individual]")
+{
+    std::vector<SubjectRequest> requests;
+    for(std::size_t r = 0; r < 40; ++r)
+    {
+        // [id, professor, complexity, groups, lessons, classrooms]
+        requests.emplace_back(r,
+                              r % 7,
+                              r % MAX_COMPLEXITY + 1,
+                              std::vector<std::size_t>{r % 5, 5 + r % 3},
+                              std::vector<std::size_t>{r % 4, 7 + r % 5, 14, 15, 16, 17, 30},
+                              std::vector<ClassroomAddress>{{r % 3, 1}, {r % 3 + 1, 2}, {4, r % 6}});
+    }
+
+    const ScheduleData data{std::move(requests)};
+
+    const std::uint64_t seed = GENERATE(1, 2, 3);
+    ScheduleIndividual first(Xoshiro256(seed), &data);
+    ScheduleIndividual second(Xoshiro256(seed + 100), &data);
+    REQUIRE(first.Evaluate() == Evaluate(first.Chromosomes(), data));
+
+    for(std::size_t i = 0; i < 300; ++i)
+    {
+        first.Mutate();
+        second.Mutate();
+        REQUIRE(first.Evaluate() == Evaluate(first.Chromosomes(), data));
+        REQUIRE(second.Evaluate() == Evaluate(second.Chromosomes(), data));
+
+        first.Crossover(second);
+        REQUIRE(first.Evaluate() == Evaluate(first.Chromosomes(), data));
+        REQUIRE(second.Evaluate() == Evaluate(second.Chromosomes(), data));
+
+        if(i % 50 == 0)
+            second = first;
+    }
+}
+
+// Requests share the professors, the groups and the classrooms,
+// the first one is allowed only at the given lessons
+static std::vector<SubjectRequest> MakeGATestRequests(std::vector<std::size_t> firstLessons = {1})
+{
+    // [id, professor, complexity, groups, lessons, classrooms]
+    return {SubjectRequest{0, 1, 1, {0}, std::move(firstLessons), {{0, 1}, {0, 2}}},
+            SubjectRequest{1, 1, 2, {1}, {}, {{0, 2}}},
+            SubjectRequest{2, 2, 3, {0, 2}, {}, {{0, 1}, {0, 3}}},
+            SubjectRequest{3, 3, 4, {2}, {}, {{0, 3}}},
+            SubjectRequest{4, 4, 1, {1, 2}, {}, {{1, 1}}}};
+}
+
+static ScheduleData MakeGATestData(std::vector<std::size_t> firstLessons = {1})
+{
+    return ScheduleData{MakeGATestRequests(std::move(firstLessons))};
+}
+
+static ScheduleGAParams MakeGATestParams(int iterationsCount)
+{
+    return ScheduleGAParams{.IndividualsCount = 20,
+                            .IterationsCount = iterationsCount,
+                            .SelectionCount = 6,
+                            .CrossoverCount = 4,
+                            .MutationChance = 50};
+}
+
+TEST_CASE("Generation stops when time limit is reached", "[schedule_ga]")
+{
+    // lower bound can't be reached: the first request is allowed only at the second lesson
+    const ScheduleData data = MakeGATestData();
+
+    ScheduleGAParams params = MakeGATestParams(std::numeric_limits<int>::max());
+    params.TimeLimit = 100;
+    ScheduleGA generator;
+    generator.SetParams(params);
+
+    ScheduleGAProgress progress;
+    const ScheduleIndividual best = generator(data, progress);
+
+    REQUIRE(progress.Iteration() > 0);
+    REQUIRE(progress.Iteration() < static_cast<std::size_t>(generator.Params().IterationsCount));
+
+    const auto anytimeBest = progress.BestIndividual();
+    REQUIRE(anytimeBest.has_value());
+    REQUIRE(anytimeBest->Evaluate() == best.Evaluate());
+    REQUIRE(progress.BestEvaluation() == best.Evaluate());
+    REQUIRE(progress.StopReason() == ScheduleGAStopReason::TimeLimit);
+}
+
+TEST_CASE("Generation stops when the best individual is not improved", "[schedule_ga]")
+{
+    const ScheduleData data = MakeGATestData();
+
+    ScheduleGAParams params = MakeGATestParams(std::numeric_limits<int>::max());
+    params.StagnationLimit = 30;
+    ScheduleGA generator;
+    generator.SetParams(params);
+
+    ScheduleGAProgress progress;
+    const ScheduleIndividual best = generator(data, progress);
+
+    REQUIRE(progress.StopReason() == ScheduleGAStopReason::Stagnation);
+    REQUIRE(progress.Iteration() == progress.ImprovementIteration() + 30);
+    REQUIRE(progress.BestEvaluation() == best.Evaluate());
+}
+
+TEST_CASE("Generation stops when the lower bound is reached", "[schedule_ga]")
+{
+    // [id, professor, complexity, groups, lessons, classrooms]
+    const ScheduleData data{{SubjectRequest{0, 1, 1, {0}, {0}, {{0, 1}}},
+                             SubjectRequest{1, 2, 1, {1}, {7}, {{0, 1}}}}};
+
+    ScheduleGA generator;
+    generator.SetParams(MakeGATestParams(100));
+
+    ScheduleGAProgress progress;
+    const ScheduleIndividual best = generator(data, progress);
+
+    REQUIRE(best.Evaluate() == EVALUATION_LOWER_BOUND);
+    REQUIRE(progress.StopReason() == ScheduleGAStopReason::LowerBound);
+    REQUIRE(progress.Iteration() == 0);
+}
+
+TEST_CASE("Generation stops when the stop is requested", "[schedule_ga]")
+{
+    const ScheduleData data = MakeGATestData();
+
+    ScheduleGAParams params = MakeGATestParams(std::numeric_limits<int>::max());
+    params.IslandsCount = GENERATE(1, 3);
+    params.MigrationInterval = 10;
+    ScheduleGA generator;
+    generator.SetParams(params);
+
+    SECTION("Stop requested before the start")
+    {
+        std::stop_source stopSource;
+        stopSource.request_stop();
+
+        ScheduleGAProgress progress;
+        const ScheduleIndividual best = generator(data, progress, stopSource.get_token());
+
+        REQUIRE(progress.Cancelled());
+        REQUIRE(progress.Iteration() == 0);
+        REQUIRE(progress.BestEvaluation() == best.Evaluate());
+    }
+    SECTION("Stop requested while the generation is running")
+    {
+        std::stop_source stopSource;
+        ScheduleGAProgress progress;
+        std::jthread stopper(
+            [&]
+            {
+                while(progress.Iteration() < 10)
+                    std::this_thread::yield();
+
+                stopSource.request_stop();
+            });
+
+        const ScheduleIndividual best = generator(data, progress, stopSource.get_token());
+
+        REQUIRE(progress.Cancelled());
+        REQUIRE(progress.Iteration() >= 10);
+        REQUIRE(progress.BestIndividual().has_value());
+        REQUIRE(progress.BestEvaluation() == best.Evaluate());
+    }
+}
+
+TEST_CASE("Generation is reproducible with the same seed", "[schedule_ga]")
+{
+    const ScheduleData data = MakeGATestData({1, 2, 3});
+
+    ScheduleGAParams params = MakeGATestParams(30);
+    params.IslandsCount = GENERATE(1, 3);
+    params.MigrationInterval = 10;
+    params.Seed = 42;
+    ScheduleGA generator;
+    generator.SetParams(params);
+
+    const ScheduleIndividual first = generator(data);
+    const ScheduleIndividual second = generator(data);
+    REQUIRE(first.Evaluate() == second.Evaluate());
+    REQUIRE(first.Chromosomes().Lessons() == second.Chromosomes().Lessons());
+    REQUIRE(first.Chromosomes().Classrooms() == second.Chromosomes().Classrooms());
+}
+
+TEST_CASE("Generation on the worker pool equals to the standard parallel one", "[schedule_ga]")
+{
+    const ScheduleData data = MakeGATestData({1, 2, 3});
+
+    ScheduleGAParams params = MakeGATestParams(30);
+    params.IslandsCount = GENERATE(1, 3);
+    params.MigrationInterval = 10;
+    params.Seed = 42;
+    ScheduleGA generator;
+    generator.SetParams(params);
+    const ScheduleIndividual expected = generator(data);
+
+    generator.SetWorkerPool(std::make_shared<ScheduleWorkerPool>(GENERATE(1u, 4u)));
+    const ScheduleIndividual pooled = generator(data);
+    REQUIRE(pooled.Evaluate() == expected.Evaluate());
+    REQUIRE(pooled.Chromosomes().Lessons() == expected.Chromosomes().Lessons());
+    REQUIRE(pooled.Chromosomes().Classrooms() == expected.Chromosomes().Classrooms());
+}
+
+TEST_CASE("Worker pool calls the function for every index", "[schedule_worker_pool]")
+{
+    ScheduleWorkerPool pool(GENERATE(1u, 3u));
+    REQUIRE(pool.ThreadsCount() > 0);
+
+    std::vector<std::atomic<int>> calls(100);
+    pool.ParallelFor(calls.size(), [&](std::size_t i) { ++calls[i]; });
+    REQUIRE(std::ranges::all_of(calls, [](auto&& count) { return count == 1; }));
+
+    pool.ParallelFor(0, [](std::size_t) { throw std::logic_error("unexpected call"); });
+    REQUIRE_THROWS_AS(
+        pool.ParallelFor(calls.size(),
+                         [](std::size_t i)
+                         {
+                             if(i == 42)
+                                 throw std::runtime_error("failed");
+                         }),
+        std::runtime_error);
+}
+
+TEST_CASE("Warm-started generation begins from the prior schedule", "[schedule_ga]")
+{
+    // the last request is added to the data of the prior schedule
+    std::vector<SubjectRequest> requests = MakeGATestRequests();
+    requests.pop_back();
+    const ScheduleData data{std::move(requests)};
+
+    ScheduleGA generator;
+    generator.SetParams(MakeGATestParams(50));
+    const ScheduleResult prior = Generate(generator, data);
+
+    const ScheduleData changedData = MakeGATestData();
+
+    // without iterations the result is the seed of the population
+    generator.SetParams(MakeGATestParams(0));
+    ScheduleGAProgress progress;
+    const ScheduleResult result = Generate(generator, changedData, prior, progress);
+
+    for(auto&& item : prior)
+        REQUIRE(std::ranges::find(result.items(), item) != result.items().end());
+
+    REQUIRE(std::ranges::count(result.items(), 4, &ScheduleItem::SubjectRequestID) == 1);
+}
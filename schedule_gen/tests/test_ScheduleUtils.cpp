@@ -1,3 +1,4 @@
+#include "ScheduleRandom.h"
 #include "ScheduleUtils.h"
 
 #include <array>
@@ -79,3 +80,41 @@ TEST_CASE("Indexing bit vector", "[bit_vector]")
             REQUIRE_FALSE(vec.get_bit(i));
     }
 }
+
+TEST_CASE("Random generator is reproducible from seed", "[random]")
+{
+    Xoshiro256 first(42);
+    Xoshiro256 second(42);
+    for(std::size_t i = 0; i < 100; ++i)
+        REQUIRE(first() == second());
+
+    REQUIRE(Xoshiro256(1)() != Xoshiro256(2)());
+}
+
+TEST_CASE("Split random generators produce different streams", "[random]")
+{
+    Xoshiro256 master(42);
+    Xoshiro256 first = master.Split();
+    Xoshiro256 second = master.Split();
+    REQUIRE(first != second);
+    REQUIRE(first != master);
+
+    std::size_t equalValuesCount = 0;
+    for(std::size_t i = 0; i < 100; ++i)
+        equalValuesCount += (first() == second());
+
+    REQUIRE(equalValuesCount == 0);
+}
+
+TEST_CASE("Compressed rows keep rows contents", "[compressed_rows]")
+{
+    const CompressedRows<std::size_t> empty;
+    REQUIRE(empty.size() == 0);
+
+    const CompressedRows<std::size_t> rows(std::vector<std::vector<std::size_t>>{{1, 2}, {}, {3}});
+    REQUIRE(rows.size() == 3);
+    REQUIRE(rows.values() == std::vector<std::size_t>{1, 2, 3});
+    REQUIRE(std::ranges::equal(rows.row(0), std::vector<std::size_t>{1, 2}));
+    REQUIRE(rows.row(1).empty());
+    REQUIRE(std::ranges::equal(rows.row(2), std::vector<std::size_t>{3}));
+}
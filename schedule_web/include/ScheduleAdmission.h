@@ -0,0 +1,83 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+
+
+struct ScheduleAdmissionStats
+{
+    std::size_t ActiveCount = 0;
+    std::size_t QueuedCount = 0;
+    std::size_t MaxActiveCount = 0;
+    std::size_t MaxQueuedCount = 0;
+    std::size_t Admitted = 0;
+    std::size_t Rejected = 0;
+    // time spent in the queue by the admitted solves
+    std::chrono::milliseconds AverageWait{0};
+    std::chrono::milliseconds MaxWait{0};
+};
+
+// Limits the count of the concurrently running solves. Other solves wait for the free slot
+// in the bounded queue in the order of arrival, the solves which don't fit into the queue
+// are rejected at once.
+class ScheduleAdmission
+{
+public:
+    // Slot of the running solve, it is released on destruction
+    class Permit
+    {
+    public:
+        Permit(Permit&& other) noexcept;
+        Permit& operator=(Permit&&) = delete;
+        ~Permit();
+
+        std::chrono::milliseconds QueueWait() const { return queueWait_; }
+
+    private:
+        friend class ScheduleAdmission;
+        Permit(ScheduleAdmission* admission, std::chrono::milliseconds queueWait);
+
+        ScheduleAdmission* admission_;
+        std::chrono::milliseconds queueWait_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    ScheduleAdmission(std::size_t maxActiveCount, std::size_t maxQueuedCount);
+
+    // Returns nullopt if the queue is full or the stop is requested while waiting
+    std::optional<Permit> Acquire(std::stop_token stopToken = {});
+    // Whether the new solve would be rejected now
+    bool Saturated() const;
+    // Rejects the new solve before its body is read if it would be rejected now,
+    // the rejection is counted like the one of Acquire
+    bool TryReject();
+    // Expected time until the new solve could be admitted, at least a second
+    std::chrono::seconds RetryAfter() const;
+
+    ScheduleAdmissionStats Stats() const;
+
+private:
+    bool SaturatedLocked() const;
+    void Release(std::chrono::steady_clock::duration solveDuration);
+
+    std::size_t maxActiveCount_;
+    std::size_t maxQueuedCount_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable_any released_;
+    std::size_t activeCount_ = 0;
+    // tickets of the waiting solves
+    std::deque<std::size_t> queue_;
+    std::size_t nextTicket_ = 0;
+
+    std::size_t admitted_ = 0;
+    std::size_t rejected_ = 0;
+    std::chrono::milliseconds totalWait_{0};
+    std::chrono::milliseconds maxWait_{0};
+    std::size_t finishedCount_ = 0;
+    std::chrono::steady_clock::duration totalSolveDuration_{0};
+};
@@ -0,0 +1,79 @@
+#pragma once
+#include "ScheduleData.h"
+#include "ScheduleGA.h"
+#include "ScheduleResult.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+
+// 128-bit digest of the solve input
+struct ScheduleCacheKey
+{
+    friend bool operator==(const ScheduleCacheKey& lhs, const ScheduleCacheKey& rhs) = default;
+
+    std::uint64_t High = 0;
+    std::uint64_t Low = 0;
+};
+
+struct ScheduleCacheKeyHash
+{
+    std::size_t operator()(const ScheduleCacheKey& key) const
+    {
+        return static_cast<std::size_t>(key.High ^ key.Low);
+    }
+};
+
+// The key depends only on the parsed data, so it doesn't change with the order of
+// subject requests, duplicates or formatting of the request body
+ScheduleCacheKey MakeScheduleCacheKey(const ScheduleData& data, const ScheduleGAParams& params);
+// Key of the warm-started solve, it doesn't depend on the order of the prior schedule items
+ScheduleCacheKey MakeScheduleCacheKey(const ScheduleData& data,
+                                      const ScheduleGAParams& params,
+                                      const ScheduleResult& prior);
+
+struct ScheduleCacheStats
+{
+    std::size_t Hits = 0;
+    std::size_t Misses = 0;
+    std::size_t EntriesCount = 0;
+    std::size_t Size = 0;
+    std::size_t Capacity = 0;
+};
+
+// LRU cache of the solve results bounded by the memory budget in bytes (0 - cache is disabled)
+class ScheduleResultCache
+{
+public:
+    explicit ScheduleResultCache(std::size_t capacity);
+
+    std::shared_ptr<const ScheduleResult> Find(const ScheduleCacheKey& key);
+    void Insert(const ScheduleCacheKey& key, std::shared_ptr<const ScheduleResult> result);
+
+    ScheduleCacheStats Stats() const;
+
+private:
+    struct Entry
+    {
+        ScheduleCacheKey Key;
+        std::shared_ptr<const ScheduleResult> Result;
+        std::size_t Size = 0;
+    };
+
+    using EntriesList = std::list<Entry>;
+
+    std::size_t capacity_;
+    std::atomic<std::size_t> hits_ = 0;
+    std::atomic<std::size_t> misses_ = 0;
+
+    mutable std::mutex mutex_;
+    std::size_t size_ = 0;
+    // the most recently used entries are in front
+    EntriesList entries_;
+    std::unordered_map<ScheduleCacheKey, EntriesList::iterator, ScheduleCacheKeyHash> index_;
+};
@@ -1,16 +1,30 @@
 #pragma once
+#include "ScheduleAdmission.h"
+#include "ScheduleCache.h"
 #include "ScheduleCommon.h"
 #include "ScheduleData.h"
 #include "ScheduleGA.h"
+#include "ScheduleJobs.h"
 #include "ScheduleResult.h"
+#include "ScheduleSessions.h"
 #include "ScheduleValidation.h"
 
 #include <nlohmann/json.hpp>
+#include <iosfwd>
+#include <optional>
 #include <vector>
 
 
 std::vector<std::size_t> ParseIDsSet(const nlohmann::json& arr);
 std::vector<std::size_t> ParseLessonsSet(const nlohmann::json& arr);
+// Optional "placed_lessons" of the solve request - the prior schedule of the warm start
+std::optional<ScheduleResult> ParsePriorSchedule(const nlohmann::json& j);
+// Streaming parser of the request body: the subject requests and the blocks are read without
+// the DOM of the whole body and give the same data as from_json. The other keys of the body
+// are stored to rest. Returns nullopt if the body has no "subject_requests".
+std::optional<ScheduleData> ReadScheduleData(std::istream& is,
+                                             nlohmann::json::input_format_t format,
+                                             nlohmann::json& rest);
 
 void from_json(const nlohmann::json& j, SubjectRequest& subjectRequest);
 void from_json(const nlohmann::json& j, std::vector<ClassroomAddress>& classrooms);
@@ -30,5 +44,11 @@ void to_json(nlohmann::json& j, const SubjectRequest& subjectRequest);
 void to_json(nlohmann::json& j, const ScheduleData& scheduleData);
 void to_json(nlohmann::json& j, const ScheduleResult& scheduleResult);
 void to_json(nlohmann::json& j, const ScheduleGAParams& params);
+void to_json(nlohmann::json& j, ScheduleGAStopReason stopReason);
+void to_json(nlohmann::json& j, ScheduleJobStatus status);
+void to_json(nlohmann::json& j, const ScheduleJobInfo& jobInfo);
+void to_json(nlohmann::json& j, const ScheduleCacheStats& cacheStats);
+void to_json(nlohmann::json& j, const ScheduleAdmissionStats& admissionStats);
+void to_json(nlohmann::json& j, const ScheduleSessionState& sessionState);
 
 nlohmann::json JsonConvertFromOldFormat(const nlohmann::json& j);
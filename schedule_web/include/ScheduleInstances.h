@@ -0,0 +1,32 @@
+#pragma once
+#include "ScheduleData.h"
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+
+// Registry of the parsed schedule data. The data is preprocessed once when it is registered
+// and shared by all the solves and checks which reference it.
+class ScheduleInstances
+{
+public:
+    explicit ScheduleInstances(std::size_t maxInstancesCount);
+
+    // Returns the ID of the new instance or nullopt if there are too many instances
+    std::optional<std::size_t> Register(std::shared_ptr<const ScheduleData> data);
+    std::shared_ptr<const ScheduleData> Find(std::size_t id) const;
+    // Running solves keep using the removed instance until they are finished
+    bool Remove(std::size_t id);
+
+    std::size_t Count() const;
+
+private:
+    std::size_t maxInstancesCount_;
+
+    mutable std::mutex mutex_;
+    std::size_t lastID_ = 0;
+    std::map<std::size_t, std::shared_ptr<const ScheduleData>> instances_;
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include "ScheduleData.h"
+#include "ScheduleGA.h"
+#include "ScheduleResult.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+enum class ScheduleJobStatus
+{
+    Queued,
+    Running,
+    Done,
+    Failed,
+    Cancelled
+};
+
+// Snapshot of the solve job state
+struct ScheduleJobInfo
+{
+    std::size_t ID = 0;
+    ScheduleJobStatus Status = ScheduleJobStatus::Queued;
+    std::size_t Iteration = 0;
+    std::size_t BestEvaluation = NOT_EVALUATED;
+    std::optional<ScheduleGAStopReason> StopReason;
+    // best schedule found, available when the job is done or cancelled while running
+    std::optional<ScheduleResult> Result;
+    std::string Error;
+};
+
+bool Finished(ScheduleJobStatus status);
+
+// Runs solves on its own bounded pool of threads, independent from the callers' threads.
+// Jobs wait in the bounded queue until a worker is free, finished jobs are kept
+// until they are removed or pushed out by newer finished jobs.
+class ScheduleJobsManager
+{
+public:
+    ScheduleJobsManager(ScheduleGA generator,
+                        std::size_t workersCount,
+                        std::size_t maxQueuedJobs,
+                        std::size_t maxFinishedJobs);
+    ~ScheduleJobsManager();
+
+    ScheduleJobsManager(const ScheduleJobsManager&) = delete;
+    ScheduleJobsManager& operator=(const ScheduleJobsManager&) = delete;
+
+    // Returns the ID of the new job or nullopt if the queue is full,
+    // the job with the prior schedule is warm-started from it
+    std::optional<std::size_t> Submit(ScheduleData data,
+                                      std::optional<ScheduleResult> prior = std::nullopt);
+    std::optional<std::size_t> Submit(std::shared_ptr<const ScheduleData> data,
+                                      std::optional<ScheduleResult> prior = std::nullopt);
+    std::optional<ScheduleJobInfo> Find(std::size_t id) const;
+    // Blocks until the job is finished
+    std::optional<ScheduleJobInfo> Wait(std::size_t id) const;
+    // Cancels the queued or running job, removes the finished one.
+    // Returns the job state after the operation or nullopt if there is no such job.
+    std::optional<ScheduleJobInfo> Cancel(std::size_t id);
+
+    std::size_t QueuedJobsCount() const;
+
+private:
+    struct Job
+    {
+        std::size_t ID = 0;
+        std::shared_ptr<const ScheduleData> Data;
+        std::optional<ScheduleResult> Prior;
+        ScheduleJobStatus Status = ScheduleJobStatus::Queued;
+        ScheduleGAProgress Progress;
+        std::stop_source StopSource;
+        std::optional<ScheduleResult> Result;
+        std::string Error;
+    };
+
+    void WorkerLoop(std::stop_token stopToken);
+    void Run(Job& job);
+    void Complete(const std::shared_ptr<Job>& job);
+    // requires locked mutex_
+    void AddFinishedJob(std::size_t id);
+    ScheduleJobInfo MakeInfo(const Job& job) const;
+
+    ScheduleGA generator_;
+    std::size_t maxQueuedJobs_;
+    std::size_t maxFinishedJobs_;
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable_any jobsChanged_;
+    std::size_t lastID_ = 0;
+    std::map<std::size_t, std::shared_ptr<Job>> jobs_;
+    std::deque<std::shared_ptr<Job>> queue_;
+    std::deque<std::size_t> finishedJobs_;
+    std::vector<std::jthread> workers_;
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include "ScheduleResult.h"
+#include "ScheduleValidation.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <string_view>
+#include <vector>
+
+
+// Writes JSON right to the stream without the DOM. The output is compact if the indent is
+// negative, otherwise it is the same as nlohmann::json::dump(indent) - the keys of the objects
+// have to be written in the alphabetical order for that.
+class ScheduleJsonWriter
+{
+public:
+    explicit ScheduleJsonWriter(std::ostream& os, int indent = -1);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    void Key(std::string_view key);
+    void Value(std::size_t value);
+    void Value(const std::vector<std::size_t>& values);
+
+private:
+    void Begin(char bracket);
+    void End(char bracket);
+    void BeforeValue();
+    void NextElement();
+    void NewLine(std::size_t level);
+
+    std::ostream& os_;
+    int indent_;
+    // whether the opened objects and arrays are still empty
+    std::vector<bool> emptyLevels_;
+    bool afterKey_ = false;
+};
+
+void WriteJson(std::ostream& os, const ScheduleResult& scheduleResult, int indent = -1);
+void WriteJson(std::ostream& os, const CheckScheduleResult& checkScheduleResult, int indent = -1);
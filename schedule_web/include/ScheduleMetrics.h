@@ -0,0 +1,110 @@
+#pragma once
+#include "ScheduleAdmission.h"
+#include "ScheduleCache.h"
+#include "ScheduleCommon.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+
+enum class ScheduleEndpoint
+{
+    MakeSchedule,
+    CheckSchedule,
+    Jobs,
+    Instances,
+    Sessions,
+    CacheStats,
+    AdmissionStats,
+    Metrics
+};
+
+constexpr std::size_t SCHEDULE_ENDPOINTS_COUNT = 8;
+
+// Endpoint of the request path, nullopt if the path is unknown
+std::optional<ScheduleEndpoint> FindScheduleEndpoint(std::string_view path);
+
+// Phases of the /makeSchedule request
+enum class ScheduleSolvePhase
+{
+    // reading of the body and the schedule data
+    Parse,
+    // generation of the schedule including the wait for the free solve slot
+    Solve,
+    // writing of the response body
+    Serialize
+};
+
+constexpr std::size_t SCHEDULE_SOLVE_PHASES_COUNT = 3;
+
+struct ScheduleHistogramSnapshot
+{
+    // counts of the values in the buckets, the last bucket is unbounded
+    std::vector<std::uint64_t> Counts;
+    std::uint64_t Count = 0;
+    std::chrono::microseconds Sum{0};
+};
+
+// Histogram of durations with fixed buckets. Observing is lock-free, so it can be done
+// on every request without contention.
+class ScheduleLatencyHistogram
+{
+public:
+    // upper bounds of the buckets in seconds
+    static constexpr std::array<double, 12> BOUNDS = {
+        0.001, 0.005, 0.01, 0.05, 0.1, 0.25, 0.5, 1.0, 5.0, 10.0, 30.0, 60.0};
+
+    void Observe(std::chrono::steady_clock::duration duration);
+    ScheduleHistogramSnapshot Snapshot() const;
+
+private:
+    std::array<std::atomic<std::uint64_t>, BOUNDS.size() + 1> counts_{};
+    std::atomic<std::uint64_t> sumMicroseconds_ = 0;
+};
+
+// Counters of the requests and the solves exposed by /metrics. All the records are lock-free,
+// the admission and the cache stats are taken only when the metrics are written.
+class ScheduleMetrics
+{
+public:
+    void RecordRequest(ScheduleEndpoint endpoint,
+                       int status,
+                       std::chrono::steady_clock::duration duration);
+    void RecordPhase(ScheduleSolvePhase phase, std::chrono::steady_clock::duration duration);
+    void RecordSolve(std::size_t iterations,
+                     std::size_t bestEvaluation,
+                     std::chrono::steady_clock::duration duration);
+
+    // Writes the metrics in the Prometheus text exposition format
+    void Write(std::ostream& os,
+               const ScheduleAdmissionStats& admissionStats,
+               const ScheduleCacheStats& cacheStats) const;
+
+private:
+    // responses by the status class: 1xx, 2xx, 3xx, 4xx and 5xx
+    static constexpr std::size_t STATUS_CLASSES_COUNT = 5;
+
+    struct EndpointMetrics
+    {
+        std::array<std::atomic<std::uint64_t>, STATUS_CLASSES_COUNT> Responses{};
+        ScheduleLatencyHistogram Latency;
+    };
+
+    std::array<EndpointMetrics, SCHEDULE_ENDPOINTS_COUNT> endpoints_;
+    std::array<ScheduleLatencyHistogram, SCHEDULE_SOLVE_PHASES_COUNT> phases_;
+
+    std::atomic<std::uint64_t> solves_ = 0;
+    std::atomic<std::uint64_t> iterations_ = 0;
+    std::atomic<std::uint64_t> solveMicroseconds_ = 0;
+    // of the last finished solve
+    std::atomic<double> iterationsPerSecond_ = 0.0;
+    // the gauge isn't written until the first solve is finished
+    std::atomic<std::size_t> bestEvaluation_ = NOT_EVALUATED;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+using ScheduleQueryParameters = std::vector<std::pair<std::string, std::string>>;
+
+// Empty value of the flag means that it is set
+bool ParseBoolParameter(const std::string& value);
+
+// Progress of the solve is streamed as server-sent events when it is requested
+// by the 'stream' query parameter or by the 'Accept: text/event-stream' header
+struct ScheduleProgressStreamOptions
+{
+    // minimal count of iterations between progress events
+    std::size_t Interval = 10;
+    // progress events include the best schedule found so far
+    bool WithSchedule = false;
+};
+
+// Options of the stream, nullopt if the progress is not streamed.
+// The 'stream' query parameter overrides the Accept header.
+std::optional<ScheduleProgressStreamOptions>
+    ParseProgressStreamOptions(std::string_view accept, const ScheduleQueryParameters& parameters);
+
+// Writes the server-sent event and flushes it to the client
+void WriteEvent(std::ostream& os, std::string_view event, const nlohmann::json& data);
@@ -1,7 +1,15 @@
 #pragma once
+#include "ScheduleAdmission.h"
+#include "ScheduleCache.h"
 #include "ScheduleData.h"
 #include "ScheduleGA.h"
+#include "ScheduleInstances.h"
+#include "ScheduleJobs.h"
+#include "ScheduleMetrics.h"
+#include "ScheduleProgressStream.h"
 #include "ScheduleResult.h"
+#include "ScheduleSessions.h"
+#include "ScheduleSolveFlights.h"
 
 #include <Poco/Net/HTTPRequestHandler.h>
 #include <Poco/Net/HTTPRequestHandlerFactory.h>
@@ -14,30 +22,201 @@
 class MakeScheduleRequestHandler : public Poco::Net::HTTPRequestHandler
 {
 public:
-    explicit MakeScheduleRequestHandler(ScheduleGA generator, std::shared_ptr<spdlog::logger> logger);
+    explicit MakeScheduleRequestHandler(ScheduleGA generator,
+                                        std::shared_ptr<ScheduleInstances> instances,
+                                        std::shared_ptr<ScheduleResultCache> resultCache,
+                                        std::shared_ptr<ScheduleSolveFlights> solveFlights,
+                                        std::shared_ptr<ScheduleAdmission> admission,
+                                        std::shared_ptr<ScheduleMetrics> metrics,
+                                        std::size_t compressionMinSize,
+                                        std::shared_ptr<spdlog::logger> logger);
     void handleRequest(Poco::Net::HTTPServerRequest& request,
                        Poco::Net::HTTPServerResponse& response) override;
 
 private:
+    // Runs the solve of the flight leader, completes the flight and caches its result
+    void RunSolve(const ScheduleData& data,
+                  const std::optional<ScheduleResult>& prior,
+                  const ScheduleCacheKey& cacheKey,
+                  const std::shared_ptr<ScheduleSolveFlight>& flight);
+    void StreamSchedule(Poco::Net::HTTPServerRequest& request,
+                        Poco::Net::HTTPServerResponse& response,
+                        const ScheduleData& data,
+                        const std::optional<ScheduleResult>& prior,
+                        const ScheduleCacheKey& cacheKey,
+                        const ScheduleProgressStreamOptions& options);
+
     std::shared_ptr<spdlog::logger> logger_;
     ScheduleGA generator_;
+    std::shared_ptr<ScheduleInstances> instances_;
+    std::shared_ptr<ScheduleResultCache> resultCache_;
+    std::shared_ptr<ScheduleSolveFlights> solveFlights_;
+    std::shared_ptr<ScheduleAdmission> admission_;
+    std::shared_ptr<ScheduleMetrics> metrics_;
+    std::size_t compressionMinSize_;
 };
 
 class CheckScheduleRequestHandler : public Poco::Net::HTTPRequestHandler
 {
 public:
+    explicit CheckScheduleRequestHandler(std::shared_ptr<ScheduleInstances> instances,
+                                         std::size_t compressionMinSize);
+    void handleRequest(Poco::Net::HTTPServerRequest& request,
+                       Poco::Net::HTTPServerResponse& response) override;
+
+private:
+    std::shared_ptr<ScheduleInstances> instances_;
+    std::size_t compressionMinSize_;
+};
+
+// Rejects the new solve at once with 503 and Retry-After when the solves queue is full
+class ScheduleOverloadedRequestHandler : public Poco::Net::HTTPRequestHandler
+{
+public:
+    explicit ScheduleOverloadedRequestHandler(std::shared_ptr<ScheduleAdmission> admission);
+    void handleRequest(Poco::Net::HTTPServerRequest& request,
+                       Poco::Net::HTTPServerResponse& response) override;
+
+private:
+    std::shared_ptr<ScheduleAdmission> admission_;
+};
+
+// Reports the running and queued solves and the time they wait in the queue
+class AdmissionStatsRequestHandler : public Poco::Net::HTTPRequestHandler
+{
+public:
+    explicit AdmissionStatsRequestHandler(std::shared_ptr<ScheduleAdmission> admission);
+    void handleRequest(Poco::Net::HTTPServerRequest& request,
+                       Poco::Net::HTTPServerResponse& response) override;
+
+private:
+    std::shared_ptr<ScheduleAdmission> admission_;
+};
+
+// Reports hits and misses of the solve results cache
+class CacheStatsRequestHandler : public Poco::Net::HTTPRequestHandler
+{
+public:
+    explicit CacheStatsRequestHandler(std::shared_ptr<ScheduleResultCache> resultCache);
+    void handleRequest(Poco::Net::HTTPServerRequest& request,
+                       Poco::Net::HTTPServerResponse& response) override;
+
+private:
+    std::shared_ptr<ScheduleResultCache> resultCache_;
+};
+
+// Reports the requests, solves, admission and cache counters in the Prometheus text format
+class MetricsRequestHandler : public Poco::Net::HTTPRequestHandler
+{
+public:
+    explicit MetricsRequestHandler(std::shared_ptr<ScheduleMetrics> metrics,
+                                   std::shared_ptr<ScheduleAdmission> admission,
+                                   std::shared_ptr<ScheduleResultCache> resultCache);
     void handleRequest(Poco::Net::HTTPServerRequest& request,
                        Poco::Net::HTTPServerResponse& response) override;
+
+private:
+    std::shared_ptr<ScheduleMetrics> metrics_;
+    std::shared_ptr<ScheduleAdmission> admission_;
+    std::shared_ptr<ScheduleResultCache> resultCache_;
+};
+
+// Records the status and the duration of the request handled by the wrapped handler
+class MeteredRequestHandler : public Poco::Net::HTTPRequestHandler
+{
+public:
+    MeteredRequestHandler(std::unique_ptr<Poco::Net::HTTPRequestHandler> handler,
+                          ScheduleEndpoint endpoint,
+                          std::shared_ptr<ScheduleMetrics> metrics);
+    void handleRequest(Poco::Net::HTTPServerRequest& request,
+                       Poco::Net::HTTPServerResponse& response) override;
+
+private:
+    std::unique_ptr<Poco::Net::HTTPRequestHandler> handler_;
+    ScheduleEndpoint endpoint_;
+    std::shared_ptr<ScheduleMetrics> metrics_;
+};
+
+// POST /jobs starts the solve job, GET /jobs/{id} reports its state or result,
+// DELETE /jobs/{id} cancels the job or removes the finished one
+class ScheduleJobsRequestHandler : public Poco::Net::HTTPRequestHandler
+{
+public:
+    explicit ScheduleJobsRequestHandler(std::shared_ptr<ScheduleJobsManager> jobs,
+                                        std::shared_ptr<ScheduleInstances> instances,
+                                        std::shared_ptr<spdlog::logger> logger);
+    void handleRequest(Poco::Net::HTTPServerRequest& request,
+                       Poco::Net::HTTPServerResponse& response) override;
+
+private:
+    std::shared_ptr<ScheduleJobsManager> jobs_;
+    std::shared_ptr<ScheduleInstances> instances_;
+    std::shared_ptr<spdlog::logger> logger_;
+};
+
+// POST /instances registers the schedule data, GET /instances/{id} describes it,
+// DELETE /instances/{id} removes it. Solve and check requests reference the registered data
+// by the "instance" key instead of the "subject_requests" of the body.
+class ScheduleInstancesRequestHandler : public Poco::Net::HTTPRequestHandler
+{
+public:
+    explicit ScheduleInstancesRequestHandler(std::shared_ptr<ScheduleInstances> instances,
+                                             std::shared_ptr<spdlog::logger> logger);
+    void handleRequest(Poco::Net::HTTPServerRequest& request,
+                       Poco::Net::HTTPServerResponse& response) override;
+
+private:
+    std::shared_ptr<ScheduleInstances> instances_;
+    std::shared_ptr<spdlog::logger> logger_;
+};
+
+// POST /sessions creates the editing session, GET /sessions/{id} reports its schedule,
+// DELETE /sessions/{id} closes it. Subject requests of the session are edited by
+// POST /sessions/{id}/requests, PUT and DELETE /sessions/{id}/requests/{requestID},
+// every edit responds with the re-optimized schedule.
+class ScheduleSessionsRequestHandler : public Poco::Net::HTTPRequestHandler
+{
+public:
+    explicit ScheduleSessionsRequestHandler(std::shared_ptr<ScheduleSessions> sessions,
+                                            std::shared_ptr<ScheduleAdmission> admission,
+                                            std::shared_ptr<spdlog::logger> logger);
+    void handleRequest(Poco::Net::HTTPServerRequest& request,
+                       Poco::Net::HTTPServerResponse& response) override;
+
+private:
+    std::shared_ptr<ScheduleSessions> sessions_;
+    std::shared_ptr<ScheduleAdmission> admission_;
+    std::shared_ptr<spdlog::logger> logger_;
 };
 
 class ScheduleRequestHandlerFactory : public Poco::Net::HTTPRequestHandlerFactory
 {
 public:
-    explicit ScheduleRequestHandlerFactory(ScheduleGA generator, std::shared_ptr<spdlog::logger> logger);
+    explicit ScheduleRequestHandlerFactory(ScheduleGA generator,
+                                           std::shared_ptr<ScheduleJobsManager> jobs,
+                                           std::shared_ptr<ScheduleSessions> sessions,
+                                           std::shared_ptr<ScheduleInstances> instances,
+                                           std::shared_ptr<ScheduleResultCache> resultCache,
+                                           std::shared_ptr<ScheduleAdmission> admission,
+                                           std::size_t compressionMinSize,
+                                           std::shared_ptr<spdlog::logger> logger);
     Poco::Net::HTTPRequestHandler*
         createRequestHandler(const Poco::Net::HTTPServerRequest&) override;
 
 private:
+    Poco::Net::HTTPRequestHandler* CreateEndpointHandler(ScheduleEndpoint endpoint);
+
     std::shared_ptr<spdlog::logger> logger_;
     ScheduleGA generator_;
+    std::shared_ptr<ScheduleJobsManager> jobs_;
+    std::shared_ptr<ScheduleSessions> sessions_;
+    std::shared_ptr<ScheduleInstances> instances_;
+    std::shared_ptr<ScheduleResultCache> resultCache_;
+    // identical concurrent requests share the running solve
+    std::shared_ptr<ScheduleSolveFlights> solveFlights_;
+    // the running solves and the queue of the waiting ones are bounded
+    std::shared_ptr<ScheduleAdmission> admission_;
+    std::shared_ptr<ScheduleMetrics> metrics_;
+    // responses shorter than this are not compressed
+    std::size_t compressionMinSize_;
 };
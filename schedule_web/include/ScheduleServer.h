@@ -1,6 +1,7 @@
 #pragma once
 #include "ScheduleGA.h"
 
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -11,6 +12,33 @@
 #include <spdlog/spdlog.h>
 
 
+// Options of the server are stored in the same JSON object as the GA parameters
+struct ScheduleServerOptions
+{
+    ScheduleGAParams GAParams = ScheduleGA::DefaultParams();
+    // memory budget of the solve results cache in bytes (0 - cache is disabled)
+    std::size_t ResultCacheCapacity = 64 * 1024 * 1024;
+    // responses shorter than this in bytes are sent uncompressed even if the client accepts gzip
+    std::size_t CompressionMinSize = 1024;
+    // solves running at once, they share the threads of the solver pool
+    std::size_t MaxActiveSolves = 1;
+    // solves waiting for the free slot, the next ones are rejected with 503
+    std::size_t MaxQueuedSolves = 8;
+    // threads of the solver pool (0 - one thread per hardware core)
+    std::size_t SolverThreads = 0;
+
+    std::uint16_t Port = 9304;
+    // threads serving the HTTP connections, separate from the solver pool
+    int HttpMaxThreads = 16;
+    // accepted connections waiting for the free HTTP thread
+    int HttpMaxQueued = 64;
+    bool HttpKeepAlive = true;
+    int HttpMaxKeepAliveRequests = 0;
+    // timeouts in milliseconds
+    int HttpKeepAliveTimeout = 10000;
+    int HttpTimeout = 60000;
+};
+
 class ScheduleServer : public Poco::Util::ServerApplication
 {
 public:
@@ -21,8 +49,12 @@ protected:
 
 private:
     std::shared_ptr<spdlog::logger> logger_;
+    ScheduleServerOptions options_;
     ScheduleGA generator_;
 };
 
+void from_json(const nlohmann::json& j, ScheduleServerOptions& options);
+void to_json(nlohmann::json& j, const ScheduleServerOptions& options);
+
 void CreateDefaultOptionsFile(const std::string& filename, spdlog::logger& logger);
-ScheduleGAParams LoadOptions(const std::string& filename, spdlog::logger& logger);
+ScheduleServerOptions LoadOptions(const std::string& filename, spdlog::logger& logger);
@@ -0,0 +1,98 @@
+#pragma once
+#include "ScheduleData.h"
+#include "ScheduleGA.h"
+#include "ScheduleResult.h"
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+
+// Snapshot of the editing session state
+struct ScheduleSessionState
+{
+    std::size_t ID = 0;
+    // count of the edits applied to the session
+    std::size_t Version = 0;
+    ScheduleResult Schedule;
+    std::size_t Evaluation = NOT_EVALUATED;
+    // iterations of the last solve
+    std::size_t Iterations = 0;
+    // IDs of the subject requests in the conflict graph neighbourhood of the last edit
+    std::vector<std::size_t> AffectedRequests;
+};
+
+// Live schedule which is re-optimized after every edit of its subject requests.
+// Placements of the requests unaffected by the edit are kept, the affected ones are placed again
+// and the short solve is warm-started from the result.
+class ScheduleSession
+{
+public:
+    explicit ScheduleSession(std::size_t id,
+                             ScheduleGA generator,
+                             ScheduleData data,
+                             ScheduleResult schedule,
+                             std::size_t evaluation,
+                             std::size_t iterations);
+
+    ScheduleSession(const ScheduleSession&) = delete;
+    ScheduleSession& operator=(const ScheduleSession&) = delete;
+
+    ScheduleSessionState State() const;
+
+    // Edits are applied one by one, the failed edit doesn't change the session
+    ScheduleSessionState AddRequest(SubjectRequest request);
+    ScheduleSessionState ModifyRequest(SubjectRequest request);
+    ScheduleSessionState RemoveRequest(std::size_t requestID);
+
+private:
+    // requires locked mutex_
+    ScheduleSessionState Apply(std::vector<SubjectRequest> requests,
+                               std::vector<std::vector<std::size_t>> blocksIDs,
+                               const std::vector<std::size_t>& changedIDs,
+                               const std::vector<std::size_t>& removedIDs);
+    ScheduleSessionState MakeState() const;
+
+    std::size_t id_;
+    ScheduleGA generator_;
+
+    mutable std::mutex mutex_;
+    ScheduleData data_;
+    std::vector<std::vector<std::size_t>> blocksIDs_;
+    ScheduleResult schedule_;
+    std::size_t version_ = 0;
+    std::size_t evaluation_;
+    std::size_t iterations_;
+    std::vector<std::size_t> affectedRequests_;
+};
+
+class ScheduleSessions
+{
+public:
+    // Sessions are created by the full solve of the generator,
+    // edits are re-optimized by the same solve limited by editTimeLimit
+    explicit ScheduleSessions(ScheduleGA generator,
+                              std::chrono::milliseconds editTimeLimit,
+                              std::size_t maxSessionsCount);
+
+    // Returns the state of the new session or nullopt if there are too many sessions
+    std::optional<ScheduleSessionState> Create(ScheduleData data,
+                                               std::optional<ScheduleResult> prior = std::nullopt);
+    std::shared_ptr<ScheduleSession> Find(std::size_t id) const;
+    bool Remove(std::size_t id);
+
+    std::size_t Count() const;
+
+private:
+    ScheduleGA generator_;
+    ScheduleGA editGenerator_;
+    std::size_t maxSessionsCount_;
+
+    mutable std::mutex mutex_;
+    std::size_t lastID_ = 0;
+    std::map<std::size_t, std::shared_ptr<ScheduleSession>> sessions_;
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include "ScheduleCache.h"
+#include "ScheduleGA.h"
+#include "ScheduleResult.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+
+struct ScheduleSolveOutcome
+{
+    // empty if the solve has failed
+    std::shared_ptr<const ScheduleResult> Result;
+    std::string Error;
+    // the solve is not started because too many solves are running and waiting
+    bool Rejected = false;
+    // time the solve has waited for the free slot
+    std::chrono::milliseconds QueueWait{0};
+};
+
+// One solve shared by all the requests with the same input.
+// The solve is stopped only when all the participants have left it.
+class ScheduleSolveFlight
+{
+public:
+    ScheduleGAProgress& Progress() { return progress_; }
+    std::stop_token StopToken() const { return stopSource_.get_token(); }
+    bool StopRequested() const { return stopSource_.stop_requested(); }
+
+    // Returns false if the flight is already stopped
+    bool Join();
+    void Leave();
+
+    void Complete(ScheduleSolveOutcome outcome);
+    bool Completed() const;
+    // Returns false if the stop is requested by the token before completion
+    bool Wait(std::stop_token stopToken) const;
+    bool WaitFor(std::chrono::milliseconds timeout) const;
+    // requires the completed flight
+    const ScheduleSolveOutcome& Outcome() const;
+
+private:
+    ScheduleGAProgress progress_;
+    std::stop_source stopSource_;
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable_any completed_;
+    std::size_t participantsCount_ = 1;
+    std::optional<ScheduleSolveOutcome> outcome_;
+};
+
+// Table of the running solves
+class ScheduleSolveFlights
+{
+public:
+    // Returns the running flight of the key or the new one,
+    // the second value is true if the caller has to run the new flight
+    std::pair<std::shared_ptr<ScheduleSolveFlight>, bool> Join(const ScheduleCacheKey& key);
+    // Removes the flight from the table, later requests start a new solve
+    void Finish(const ScheduleCacheKey& key, const std::shared_ptr<ScheduleSolveFlight>& flight);
+
+    std::size_t Count() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<ScheduleCacheKey, std::shared_ptr<ScheduleSolveFlight>, ScheduleCacheKeyHash>
+        flights_;
+};
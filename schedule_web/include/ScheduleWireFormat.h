@@ -0,0 +1,77 @@
+#pragma once
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+
+// Encodings of the same JSON schema
+enum class ScheduleWireFormat
+{
+    Json,
+    Cbor,
+    MessagePack
+};
+
+// Format of the request body by its Content-Type, unknown types are read as JSON
+ScheduleWireFormat RequestWireFormat(std::string_view contentType);
+// The first supported media type of the Accept header, JSON by default
+ScheduleWireFormat ResponseWireFormat(std::string_view accept);
+std::string_view ContentType(ScheduleWireFormat format);
+nlohmann::json::input_format_t InputFormat(ScheduleWireFormat format);
+
+// JSON is compact if the indent is negative
+void WriteBody(std::ostream& os,
+               const nlohmann::json& body,
+               ScheduleWireFormat format,
+               int indent = -1);
+
+
+// Content codings of the request and response bodies
+enum class ScheduleContentEncoding
+{
+    Identity,
+    Gzip,
+    Deflate
+};
+
+// Coding of the request body by its Content-Encoding, nullopt if it is not supported
+std::optional<ScheduleContentEncoding> RequestContentEncoding(std::string_view contentEncoding);
+// The first supported coding of the Accept-Encoding header which is not refused by q=0,
+// identity by default
+ScheduleContentEncoding ResponseContentEncoding(std::string_view acceptEncoding);
+std::string_view ContentEncodingName(ScheduleContentEncoding encoding);
+
+// Holds the beginning of the response body until it is known whether the body is worth
+// compressing. The stream of the body is opened by the callback once the body reaches
+// the minimum size, or by Finish with the size of the whole body if it is shorter.
+class ScheduleBodyBuffer final : public std::streambuf
+{
+public:
+    using OpenStream = std::function<std::ostream&(std::optional<std::size_t> bodySize)>;
+
+    ScheduleBodyBuffer(std::size_t compressionMinSize, OpenStream openStream);
+
+    // Writes the rest of the body to the stream, opens it if the body is short
+    void Finish();
+
+protected:
+    int_type overflow(int_type ch) override;
+    int sync() override;
+
+private:
+    void FlushChunk();
+    void Open(std::optional<std::size_t> bodySize);
+
+    std::size_t compressionMinSize_;
+    OpenStream openStream_;
+    std::string head_;
+    std::ostream* stream_ = nullptr;
+    std::array<char, 4096> chunk_{};
+};
@@ -0,0 +1,135 @@
+#include "ScheduleAdmission.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+
+ScheduleAdmission::Permit::Permit(ScheduleAdmission* admission, std::chrono::milliseconds queueWait)
+    : admission_(admission)
+    , queueWait_(queueWait)
+    , start_(std::chrono::steady_clock::now())
+{
+}
+
+ScheduleAdmission::Permit::Permit(Permit&& other) noexcept
+    : admission_(std::exchange(other.admission_, nullptr))
+    , queueWait_(other.queueWait_)
+    , start_(other.start_)
+{
+}
+
+ScheduleAdmission::Permit::~Permit()
+{
+    if(admission_ != nullptr)
+        admission_->Release(std::chrono::steady_clock::now() - start_);
+}
+
+
+ScheduleAdmission::ScheduleAdmission(std::size_t maxActiveCount, std::size_t maxQueuedCount)
+    : maxActiveCount_(maxActiveCount)
+    , maxQueuedCount_(maxQueuedCount)
+{
+    if(maxActiveCount_ < 1)
+        throw std::invalid_argument("Invalid max active solves count: must be greater than zero");
+}
+
+std::optional<ScheduleAdmission::Permit> ScheduleAdmission::Acquire(std::stop_token stopToken)
+{
+    std::unique_lock lock(mutex_);
+    if(SaturatedLocked())
+    {
+        ++rejected_;
+        return std::nullopt;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t ticket = nextTicket_++;
+    queue_.push_back(ticket);
+    const bool admitted = released_.wait(lock,
+                                         stopToken,
+                                         [&]
+                                         {
+                                             return activeCount_ < maxActiveCount_
+                                                    && queue_.front() == ticket;
+                                         });
+
+    queue_.erase(std::ranges::find(queue_, ticket));
+    // the next solve of the queue could be admitted too or it is the front one now
+    released_.notify_all();
+    if(!admitted)
+        return std::nullopt;
+
+    const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    ++activeCount_;
+    ++admitted_;
+    totalWait_ += wait;
+    maxWait_ = std::max(maxWait_, wait);
+    return Permit(this, wait);
+}
+
+bool ScheduleAdmission::Saturated() const
+{
+    std::lock_guard lock(mutex_);
+    return SaturatedLocked();
+}
+
+bool ScheduleAdmission::TryReject()
+{
+    std::lock_guard lock(mutex_);
+    if(!SaturatedLocked())
+        return false;
+
+    ++rejected_;
+    return true;
+}
+
+std::chrono::seconds ScheduleAdmission::RetryAfter() const
+{
+    std::lock_guard lock(mutex_);
+    if(finishedCount_ == 0)
+        return std::chrono::seconds{1};
+
+    // the queue and the new solve are admitted by the max active count at once
+    const auto averageSolve = totalSolveDuration_ / finishedCount_;
+    const auto rounds = (queue_.size() + maxActiveCount_) / maxActiveCount_;
+    const auto retryAfter = std::chrono::ceil<std::chrono::seconds>(averageSolve * rounds);
+    return std::max(retryAfter, std::chrono::seconds{1});
+}
+
+ScheduleAdmissionStats ScheduleAdmission::Stats() const
+{
+    std::lock_guard lock(mutex_);
+    return ScheduleAdmissionStats{
+        .ActiveCount = activeCount_,
+        .QueuedCount = queue_.size(),
+        .MaxActiveCount = maxActiveCount_,
+        .MaxQueuedCount = maxQueuedCount_,
+        .Admitted = admitted_,
+        .Rejected = rejected_,
+        .AverageWait = admitted_ > 0 ? std::chrono::duration_cast<std::chrono::milliseconds>(
+                                           totalWait_ / admitted_)
+                                     : std::chrono::milliseconds{0},
+        .MaxWait = maxWait_};
+}
+
+bool ScheduleAdmission::SaturatedLocked() const
+{
+    const bool waits = activeCount_ >= maxActiveCount_ || !queue_.empty();
+    return waits && queue_.size() >= maxQueuedCount_;
+}
+
+void ScheduleAdmission::Release(std::chrono::steady_clock::duration solveDuration)
+{
+    {
+        std::lock_guard lock(mutex_);
+        assert(activeCount_ > 0);
+        --activeCount_;
+        ++finishedCount_;
+        totalSolveDuration_ += solveDuration;
+    }
+
+    released_.notify_all();
+}
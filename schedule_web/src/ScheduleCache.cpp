@@ -0,0 +1,182 @@
+#include "ScheduleCache.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <tuple>
+
+
+// Two independent 64-bit streams give the 128-bit digest
+class ScheduleHasher
+{
+public:
+    void Add(std::uint64_t value)
+    {
+        high_ = Mix(high_ + value + 0x9E3779B97F4A7C15);
+        low_ = Mix(std::rotl(low_, 23) ^ (value * 0xD6E8FEB86659FD93));
+    }
+
+    template<class Range>
+    void AddRange(const Range& values)
+    {
+        // size prefix separates the neighbouring ranges
+        Add(std::size(values));
+        for(auto&& value : values)
+            Add(value);
+    }
+
+    ScheduleCacheKey Digest() const { return ScheduleCacheKey{.High = high_, .Low = low_}; }
+
+private:
+    static std::uint64_t Mix(std::uint64_t x)
+    {
+        // finalizer of MurmurHash3
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCD;
+        x ^= x >> 33;
+        x *= 0xC4CEB9FE1A85EC53;
+        x ^= x >> 33;
+        return x;
+    }
+
+    std::uint64_t high_ = 0x6A09E667F3BCC908;
+    std::uint64_t low_ = 0xBB67AE8584CAA73B;
+};
+
+static void AddInput(ScheduleHasher& hasher,
+                     const ScheduleData& data,
+                     const ScheduleGAParams& params)
+{
+    hasher.Add(params.IndividualsCount);
+    hasher.Add(params.IterationsCount);
+    hasher.Add(params.SelectionCount);
+    hasher.Add(params.CrossoverCount);
+    hasher.Add(params.MutationChance);
+    hasher.Add(params.IslandsCount);
+    hasher.Add(params.MigrationInterval);
+    hasher.Add(params.TimeLimit);
+    hasher.Add(params.StagnationLimit);
+    hasher.Add(params.Seed);
+
+    // subject requests are sorted by ID and unique in the parsed data
+    const auto& requests = data.SubjectRequests();
+    hasher.Add(requests.size());
+    for(auto&& request : requests)
+    {
+        hasher.Add(request.ID());
+        hasher.Add(request.Professor());
+        hasher.Add(request.Complexity());
+        hasher.AddRange(request.Groups());
+        hasher.AddRange(request.Lessons());
+        hasher.Add(request.Classrooms().size());
+        for(auto&& classroom : request.Classrooms())
+        {
+            hasher.Add(classroom.Building);
+            hasher.Add(classroom.Classroom);
+        }
+    }
+
+    hasher.Add(data.Blocks().size());
+    for(auto&& block : data.Blocks())
+    {
+        hasher.AddRange(block.Requests());
+        hasher.AddRange(block.Addresses());
+    }
+}
+
+ScheduleCacheKey MakeScheduleCacheKey(const ScheduleData& data, const ScheduleGAParams& params)
+{
+    ScheduleHasher hasher;
+    AddInput(hasher, data, params);
+    return hasher.Digest();
+}
+
+ScheduleCacheKey MakeScheduleCacheKey(const ScheduleData& data,
+                                      const ScheduleGAParams& params,
+                                      const ScheduleResult& prior)
+{
+    ScheduleHasher hasher;
+    AddInput(hasher, data, params);
+
+    // items are ordered only by address in the result
+    std::vector<ScheduleItem> items = prior.items();
+    std::ranges::sort(items,
+                      [](const ScheduleItem& lhs, const ScheduleItem& rhs)
+                      {
+                          return std::tie(lhs.Address, lhs.SubjectRequestID, lhs.Classroom)
+                                 < std::tie(rhs.Address, rhs.SubjectRequestID, rhs.Classroom);
+                      });
+
+    hasher.Add(items.size());
+    for(auto&& item : items)
+    {
+        hasher.Add(item.Address);
+        hasher.Add(item.SubjectRequestID);
+        hasher.Add(item.Classroom);
+    }
+
+    return hasher.Digest();
+}
+
+ScheduleResultCache::ScheduleResultCache(std::size_t capacity)
+    : capacity_(capacity)
+{
+}
+
+std::shared_ptr<const ScheduleResult> ScheduleResultCache::Find(const ScheduleCacheKey& key)
+{
+    std::unique_lock lock(mutex_);
+    const auto it = index_.find(key);
+    if(it == index_.end())
+    {
+        lock.unlock();
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    entries_.splice(entries_.begin(), entries_, it->second);
+    auto result = it->second->Result;
+    lock.unlock();
+
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return result;
+}
+
+void ScheduleResultCache::Insert(const ScheduleCacheKey& key,
+                                 std::shared_ptr<const ScheduleResult> result)
+{
+    assert(result != nullptr);
+    const std::size_t size = sizeof(Entry) + sizeof(ScheduleResult)
+                              + result->items().size() * sizeof(ScheduleItem);
+    if(size > capacity_)
+        return;
+
+    std::lock_guard lock(mutex_);
+    if(const auto it = index_.find(key); it != index_.end())
+    {
+        size_ -= it->second->Size;
+        entries_.erase(it->second);
+        index_.erase(it);
+    }
+
+    while(size_ + size > capacity_)
+    {
+        size_ -= entries_.back().Size;
+        index_.erase(entries_.back().Key);
+        entries_.pop_back();
+    }
+
+    entries_.push_front(Entry{.Key = key, .Result = std::move(result), .Size = size});
+    index_.emplace(key, entries_.begin());
+    size_ += size;
+}
+
+ScheduleCacheStats ScheduleResultCache::Stats() const
+{
+    std::lock_guard lock(mutex_);
+    return ScheduleCacheStats{.Hits = hits_.load(std::memory_order_relaxed),
+                              .Misses = misses_.load(std::memory_order_relaxed),
+                              .EntriesCount = entries_.size(),
+                              .Size = size_,
+                              .Capacity = capacity_};
+}
@@ -2,9 +2,68 @@
 
 #include "ScheduleUtils.h"
 
+#include <istream>
 #include <set>
+#include <string>
 
 
+template<typename T>
+static void MakeSortedSet(std::vector<T>& values)
+{
+    std::ranges::sort(values);
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    values.shrink_to_fit();
+}
+
+static std::size_t ParseID(const nlohmann::json& value)
+{
+    const auto v = value.get<std::int64_t>();
+    if(value < 0)
+        throw std::invalid_argument("ID can't be negative");
+
+    return static_cast<std::size_t>(v);
+}
+
+static std::size_t ParseLesson(const nlohmann::json& value)
+{
+    const auto v = value.get<std::int64_t>();
+    if(value < 0 || value >= MAX_LESSONS_COUNT)
+        throw std::out_of_range("Lesson value must be in range [0, "
+                                + std::to_string(MAX_LESSONS_COUNT) + ')');
+
+    return static_cast<std::size_t>(v);
+}
+
+static std::size_t ParseClassroom(const nlohmann::json& value)
+{
+    const auto classroom = value.get<std::int64_t>();
+    if(classroom < 0)
+        throw std::invalid_argument("Classroom ID must be positive number");
+
+    return static_cast<std::size_t>(classroom);
+}
+
+static ScheduleData MakeScheduleData(std::vector<SubjectRequest> requests,
+                                     std::vector<std::vector<std::size_t>> blocksIds)
+{
+    if(requests.empty())
+        throw std::invalid_argument("'subject_requests' array is empty");
+
+    std::ranges::sort(requests, {}, &SubjectRequest::ID);
+    requests.erase(std::unique(requests.begin(), requests.end(), SubjectRequestIDEqual()),
+                   requests.end());
+
+    requests.shrink_to_fit();
+
+    blocksIds.erase(std::remove_if(blocksIds.begin(),
+                                   blocksIds.end(),
+                                   [](const std::vector<std::size_t>& b) { return b.size() < 2; }),
+                    blocksIds.end());
+
+    auto blocks = ToSubjectsBlocks(requests, blocksIds);
+    return ScheduleData(std::move(requests), std::move(blocks));
+}
+
 std::vector<std::size_t> ParseIDsSet(const nlohmann::json& arr)
 {
     if(!arr.is_array())
@@ -13,17 +72,9 @@ std::vector<std::size_t> ParseIDsSet(const nlohmann::json& arr)
     std::vector<std::size_t> result;
     result.reserve(arr.size());
     for(auto&& value : arr)
-    {
-        const auto v = value.get<std::int64_t>();
-        if(value < 0)
-            throw std::invalid_argument("ID can't be negative");
+        result.emplace_back(ParseID(value));
 
-        result.emplace_back(static_cast<std::size_t>(v));
-    }
-
-    std::ranges::sort(result);
-    result.erase(std::unique(result.begin(), result.end()), result.end());
-    result.shrink_to_fit();
+    MakeSortedSet(result);
     return result;
 }
 
@@ -35,18 +86,9 @@ std::vector<std::size_t> ParseLessonsSet(const nlohmann::json& arr)
     std::vector<std::size_t> result;
     result.reserve(arr.size());
     for(auto&& value : arr)
-    {
-        const auto v = value.get<std::int64_t>();
-        if(value < 0 || value >= MAX_LESSONS_COUNT)
-            throw std::out_of_range("Lesson value must be in range [0, "
-                                    + std::to_string(MAX_LESSONS_COUNT) + ')');
+        result.emplace_back(ParseLesson(value));
 
-        result.emplace_back(static_cast<std::size_t>(v));
-    }
-
-    std::ranges::sort(result);
-    result.erase(std::unique(result.begin(), result.end()), result.end());
-    result.shrink_to_fit();
+    MakeSortedSet(result);
     return result;
 }
 
@@ -54,10 +96,7 @@ void from_json(const nlohmann::json& j, SubjectRequest& subjectRequest)
 {
     std::vector<ClassroomAddress> classrooms;
     j.at("classrooms").get_to(classrooms);
-
-    std::ranges::sort(classrooms);
-    classrooms.erase(std::unique(classrooms.begin(), classrooms.end()), classrooms.end());
-    classrooms.shrink_to_fit();
+    MakeSortedSet(classrooms);
 
     subjectRequest = SubjectRequest(j.at("id").get<std::size_t>(),
                                     j.at("professor").get<std::size_t>(),
@@ -80,50 +119,303 @@ void from_json(const nlohmann::json& j, std::vector<ClassroomAddress>& classroom
             throw std::invalid_argument("Json array expected");
 
         for(auto&& cr : jsonClassrooms)
-        {
-            auto classroom = cr.get<std::int64_t>();
-            if(classroom < 0)
-                throw std::invalid_argument("Classroom ID must be positive number");
-
-            classrooms.emplace_back(building, classroom);
-        }
+            classrooms.emplace_back(building, ParseClassroom(cr));
     }
 
-    std::ranges::sort(classrooms);
-    classrooms.erase(std::unique(classrooms.begin(), classrooms.end()), classrooms.end());
-    classrooms.shrink_to_fit();
+    MakeSortedSet(classrooms);
 }
 
 void from_json(const nlohmann::json& j, ScheduleData& scheduleData)
 {
     std::vector<SubjectRequest> requests;
     j.at("subject_requests").get_to(requests);
-    if(requests.empty())
-        throw std::invalid_argument("'subject_requests' array is empty");
-
-    std::ranges::sort(requests, {}, &SubjectRequest::ID);
-    requests.erase(std::unique(requests.begin(), requests.end(), SubjectRequestIDEqual()),
-                   requests.end());
 
-    requests.shrink_to_fit();
-
-    std::vector<SubjectsBlock> blocks;
+    std::vector<std::vector<std::size_t>> blocksIds;
     auto it = j.find("blocks");
     if(it != j.end())
-    {
-        std::vector<std::vector<std::size_t>> blocksIds;
         it->get_to(blocksIds);
 
-        blocksIds.erase(std::remove_if(blocksIds.begin(),
-                                       blocksIds.end(),
-                                       [](const std::vector<std::size_t>& b)
-                                       { return b.size() < 2; }),
-                        blocksIds.end());
+    scheduleData = MakeScheduleData(std::move(requests), std::move(blocksIds));
+}
+
+
+// Builds the subject requests and the blocks right from the parser events, the values are
+// checked by the same rules as the DOM ones. The other keys of the body are built as DOM.
+class ScheduleDataReader final : public nlohmann::json_sax<nlohmann::json>
+{
+public:
+    explicit ScheduleDataReader(nlohmann::json& rest)
+        : rest_(rest)
+    {
+        rest_ = nlohmann::json::object();
+    }
+
+    bool null() override { return Value(nullptr); }
+    bool boolean(bool val) override { return Value(val); }
+    bool number_integer(number_integer_t val) override { return Value(val); }
+    bool number_unsigned(number_unsigned_t val) override { return Value(val); }
+    bool number_float(number_float_t val, const string_t&) override { return Value(val); }
+    bool string(string_t& val) override { return Value(std::move(val)); }
+    bool binary(binary_t& val) override { return Value(nlohmann::json::binary(std::move(val))); }
+
+    bool start_object(std::size_t) override { return Start(nlohmann::json::value_t::object); }
+    bool end_object() override { return End(); }
+    bool start_array(std::size_t) override { return Start(nlohmann::json::value_t::array); }
+    bool end_array() override { return End(); }
+
+    bool key(string_t& val) override
+    {
+        key_ = std::move(val);
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::json::exception& ex) override
+    {
+        throw std::invalid_argument(ex.what());
+    }
+
+    std::optional<ScheduleData> Result()
+    {
+        if(!requests_)
+            return std::nullopt;
 
-        blocks = ToSubjectsBlocks(requests, blocksIds);
+        return MakeScheduleData(std::move(*requests_), std::move(blocksIds_));
     }
 
-    scheduleData = ScheduleData(std::move(requests), std::move(blocks));
+private:
+    enum class Frame
+    {
+        Root,
+        Requests,
+        Request,
+        Groups,
+        Lessons,
+        Classrooms,
+        Building,
+        Blocks,
+        Block,
+        Rest,
+        Skip
+    };
+
+    struct RequestFields
+    {
+        std::optional<std::size_t> ID;
+        std::optional<std::size_t> Professor;
+        std::optional<std::size_t> Complexity;
+        std::optional<std::vector<std::size_t>> Groups;
+        std::optional<std::vector<std::size_t>> Lessons;
+        std::optional<std::vector<ClassroomAddress>> Classrooms;
+    };
+
+    bool Value(nlohmann::json value)
+    {
+        if(frames_.empty())
+            throw std::invalid_argument("Json object expected");
+
+        switch(frames_.back())
+        {
+        case Frame::Root:
+            if(key_ == "subject_requests" || key_ == "blocks")
+                throw std::invalid_argument("Json array expected");
+
+            rest_[key_] = std::move(value);
+            break;
+        case Frame::Requests: throw std::invalid_argument("Json object expected");
+        case Frame::Request: SetField(value); break;
+        case Frame::Groups: request_.Groups->emplace_back(ParseID(value)); break;
+        case Frame::Lessons: request_.Lessons->emplace_back(ParseLesson(value)); break;
+        case Frame::Classrooms: throw std::invalid_argument("Json array expected");
+        case Frame::Building:
+            request_.Classrooms->emplace_back(building_, ParseClassroom(value));
+            break;
+        case Frame::Blocks: throw std::invalid_argument("Json array expected");
+        case Frame::Block: blocksIds_.back().emplace_back(value.get<std::size_t>()); break;
+        case Frame::Rest: AddRestValue(std::move(value)); break;
+        case Frame::Skip: break;
+        }
+
+        return true;
+    }
+
+    void SetField(const nlohmann::json& value)
+    {
+        if(key_ == "id")
+            request_.ID = value.get<std::size_t>();
+        else if(key_ == "professor")
+            request_.Professor = value.get<std::size_t>();
+        else if(key_ == "complexity")
+            request_.Complexity = value.get<std::size_t>();
+        else if(key_ == "groups" || key_ == "lessons" || key_ == "classrooms")
+            throw std::invalid_argument("Json array expected");
+    }
+
+    bool Start(nlohmann::json::value_t type)
+    {
+        const bool array = type == nlohmann::json::value_t::array;
+        if(frames_.empty())
+        {
+            if(array)
+                throw std::invalid_argument("Json object expected");
+
+            frames_.emplace_back(Frame::Root);
+            return true;
+        }
+
+        switch(frames_.back())
+        {
+        case Frame::Root:
+            if(key_ == "subject_requests" || key_ == "blocks")
+            {
+                if(!array)
+                    throw std::invalid_argument("Json array expected");
+
+                // the last of the duplicated keys is used like in the DOM
+                if(key_ == "subject_requests")
+                    requests_.emplace();
+                else
+                    blocksIds_.clear();
+
+                frames_.emplace_back(key_ == "blocks" ? Frame::Blocks : Frame::Requests);
+            }
+            else
+            {
+                restValues_.emplace_back(&(rest_[key_] = nlohmann::json(type)));
+                frames_.emplace_back(Frame::Rest);
+            }
+            break;
+        case Frame::Requests:
+            if(array)
+                throw std::invalid_argument("Json object expected");
+
+            request_ = {};
+            frames_.emplace_back(Frame::Request);
+            break;
+        case Frame::Request: StartField(array); break;
+        case Frame::Classrooms:
+            if(!array)
+                throw std::invalid_argument("Json array expected");
+
+            frames_.emplace_back(Frame::Building);
+            break;
+        case Frame::Blocks:
+            if(!array)
+                throw std::invalid_argument("Json array expected");
+
+            blocksIds_.emplace_back();
+            frames_.emplace_back(Frame::Block);
+            break;
+        case Frame::Rest:
+            restValues_.emplace_back(AddRestValue(nlohmann::json(type)));
+            frames_.emplace_back(Frame::Rest);
+            break;
+        case Frame::Skip: frames_.emplace_back(Frame::Skip); break;
+        default: throw std::invalid_argument("Json number expected");
+        }
+
+        return true;
+    }
+
+    void StartField(bool array)
+    {
+        if(key_ == "id" || key_ == "professor" || key_ == "complexity")
+            throw std::invalid_argument("Json number expected");
+
+        if(key_ != "groups" && key_ != "lessons" && key_ != "classrooms")
+        {
+            frames_.emplace_back(Frame::Skip);
+            return;
+        }
+
+        if(!array)
+            throw std::invalid_argument("Json array expected");
+
+        if(key_ == "groups")
+        {
+            request_.Groups.emplace();
+            frames_.emplace_back(Frame::Groups);
+        }
+        else if(key_ == "lessons")
+        {
+            request_.Lessons.emplace();
+            frames_.emplace_back(Frame::Lessons);
+        }
+        else
+        {
+            request_.Classrooms.emplace();
+            building_ = 0;
+            frames_.emplace_back(Frame::Classrooms);
+        }
+    }
+
+    bool End()
+    {
+        const Frame frame = frames_.back();
+        frames_.pop_back();
+        switch(frame)
+        {
+        case Frame::Request: requests_->emplace_back(MakeRequest()); break;
+        case Frame::Groups: MakeSortedSet(*request_.Groups); break;
+        case Frame::Lessons: MakeSortedSet(*request_.Lessons); break;
+        case Frame::Classrooms: MakeSortedSet(*request_.Classrooms); break;
+        case Frame::Building: ++building_; break;
+        case Frame::Rest: restValues_.pop_back(); break;
+        default: break;
+        }
+
+        return true;
+    }
+
+    SubjectRequest MakeRequest()
+    {
+        if(!request_.Classrooms)
+            throw std::invalid_argument("'classrooms' key expected");
+        if(!request_.ID)
+            throw std::invalid_argument("'id' key expected");
+        if(!request_.Professor)
+            throw std::invalid_argument("'professor' key expected");
+        if(!request_.Complexity)
+            throw std::invalid_argument("'complexity' key expected");
+        if(!request_.Groups)
+            throw std::invalid_argument("'groups' key expected");
+        if(!request_.Lessons)
+            throw std::invalid_argument("'lessons' key expected");
+
+        return SubjectRequest(*request_.ID,
+                              *request_.Professor,
+                              *request_.Complexity,
+                              std::move(*request_.Groups),
+                              std::move(*request_.Lessons),
+                              std::move(*request_.Classrooms));
+    }
+
+    nlohmann::json* AddRestValue(nlohmann::json value)
+    {
+        nlohmann::json& parent = *restValues_.back();
+        if(parent.is_array())
+            return &parent.emplace_back(std::move(value));
+
+        return &(parent[key_] = std::move(value));
+    }
+
+    nlohmann::json& rest_;
+    std::vector<Frame> frames_;
+    std::string key_;
+
+    std::optional<std::vector<SubjectRequest>> requests_;
+    RequestFields request_;
+    std::size_t building_ = 0;
+    std::vector<std::vector<std::size_t>> blocksIds_;
+    std::vector<nlohmann::json*> restValues_;
+};
+
+std::optional<ScheduleData> ReadScheduleData(std::istream& is,
+                                             nlohmann::json::input_format_t format,
+                                             nlohmann::json& rest)
+{
+    ScheduleDataReader reader(rest);
+    nlohmann::json::sax_parse(is, &reader, format);
+    return reader.Result();
 }
 
 void from_json(const nlohmann::json& j, ScheduleGAParams& params)
@@ -133,6 +425,13 @@ void from_json(const nlohmann::json& j, ScheduleGAParams& params)
     j.at("selection_count").get_to(params.SelectionCount);
     j.at("crossover_count").get_to(params.CrossoverCount);
     j.at("mutation_chance").get_to(params.MutationChance);
+
+    const auto defaultParams = ScheduleGA::DefaultParams();
+    params.IslandsCount = j.value("islands_count", defaultParams.IslandsCount);
+    params.MigrationInterval = j.value("migration_interval", defaultParams.MigrationInterval);
+    params.TimeLimit = j.value("time_limit", defaultParams.TimeLimit);
+    params.StagnationLimit = j.value("stagnation_limit", defaultParams.StagnationLimit);
+    params.Seed = j.value("seed", defaultParams.Seed);
 }
 
 void to_json(nlohmann::json& j, const ScheduleItem& scheduleItem)
@@ -189,7 +488,84 @@ void to_json(nlohmann::json& j, const ScheduleGAParams& params)
          {"iterations_count", params.IterationsCount},
          {"selection_count", params.SelectionCount},
          {"crossover_count", params.CrossoverCount},
-         {"mutation_chance", params.MutationChance}};
+         {"mutation_chance", params.MutationChance},
+         {"islands_count", params.IslandsCount},
+         {"migration_interval", params.MigrationInterval},
+         {"time_limit", params.TimeLimit},
+         {"stagnation_limit", params.StagnationLimit},
+         {"seed", params.Seed}};
+}
+
+void to_json(nlohmann::json& j, ScheduleGAStopReason stopReason)
+{
+    switch(stopReason)
+    {
+    case ScheduleGAStopReason::IterationsLimit: j = "iterations_limit"; break;
+    case ScheduleGAStopReason::TimeLimit: j = "time_limit"; break;
+    case ScheduleGAStopReason::Stagnation: j = "stagnation"; break;
+    case ScheduleGAStopReason::LowerBound: j = "lower_bound"; break;
+    case ScheduleGAStopReason::Cancelled: j = "cancelled"; break;
+    }
+}
+
+void to_json(nlohmann::json& j, ScheduleJobStatus status)
+{
+    switch(status)
+    {
+    case ScheduleJobStatus::Queued: j = "queued"; break;
+    case ScheduleJobStatus::Running: j = "running"; break;
+    case ScheduleJobStatus::Done: j = "done"; break;
+    case ScheduleJobStatus::Failed: j = "failed"; break;
+    case ScheduleJobStatus::Cancelled: j = "cancelled"; break;
+    }
+}
+
+void to_json(nlohmann::json& j, const ScheduleJobInfo& jobInfo)
+{
+    j = {{"id", jobInfo.ID}, {"status", jobInfo.Status}, {"iteration", jobInfo.Iteration}};
+    if(jobInfo.BestEvaluation != NOT_EVALUATED)
+        j["best_evaluation"] = jobInfo.BestEvaluation;
+
+    if(jobInfo.StopReason)
+        j["stop_reason"] = *jobInfo.StopReason;
+
+    if(jobInfo.Result)
+        j["result"] = *jobInfo.Result;
+
+    if(!jobInfo.Error.empty())
+        j["error"] = jobInfo.Error;
+}
+
+void to_json(nlohmann::json& j, const ScheduleCacheStats& cacheStats)
+{
+    j = {{"hits", cacheStats.Hits},
+         {"misses", cacheStats.Misses},
+         {"entries_count", cacheStats.EntriesCount},
+         {"size", cacheStats.Size},
+         {"capacity", cacheStats.Capacity}};
+}
+
+void to_json(nlohmann::json& j, const ScheduleAdmissionStats& admissionStats)
+{
+    j = {{"active_solves", admissionStats.ActiveCount},
+         {"queued_solves", admissionStats.QueuedCount},
+         {"max_active_solves", admissionStats.MaxActiveCount},
+         {"max_queued_solves", admissionStats.MaxQueuedCount},
+         {"admitted", admissionStats.Admitted},
+         {"rejected", admissionStats.Rejected},
+         {"average_queue_wait_ms", admissionStats.AverageWait.count()},
+         {"max_queue_wait_ms", admissionStats.MaxWait.count()}};
+}
+
+void to_json(nlohmann::json& j, const ScheduleSessionState& sessionState)
+{
+    j = {{"id", sessionState.ID},
+         {"version", sessionState.Version},
+         {"iterations", sessionState.Iterations},
+         {"affected_requests", sessionState.AffectedRequests},
+         {"placed_lessons", sessionState.Schedule}};
+    if(sessionState.Evaluation != NOT_EVALUATED)
+        j["evaluation"] = sessionState.Evaluation;
 }
 
 void from_json(const nlohmann::json& j, ScheduleItem& scheduleItem)
@@ -242,6 +618,15 @@ void from_json(const nlohmann::json& j, ScheduleResult& scheduleResult)
     scheduleResult = ScheduleResult(std::move(scheduleItems));
 }
 
+std::optional<ScheduleResult> ParsePriorSchedule(const nlohmann::json& j)
+{
+    const auto it = j.find("placed_lessons");
+    if(it == j.end())
+        return std::nullopt;
+
+    return it->get<ScheduleResult>();
+}
+
 
 constexpr bool IsLateScheduleLessonInSaturday(std::size_t l)
 {
@@ -0,0 +1,42 @@
+#include "ScheduleInstances.h"
+
+#include <cassert>
+#include <stdexcept>
+
+
+ScheduleInstances::ScheduleInstances(std::size_t maxInstancesCount)
+    : maxInstancesCount_(maxInstancesCount)
+{
+    if(maxInstancesCount_ < 1)
+        throw std::invalid_argument("Invalid max instances count: must be greater than zero");
+}
+
+std::optional<std::size_t> ScheduleInstances::Register(std::shared_ptr<const ScheduleData> data)
+{
+    assert(data != nullptr);
+    std::lock_guard lock(mutex_);
+    if(instances_.size() >= maxInstancesCount_)
+        return std::nullopt;
+
+    instances_.emplace(++lastID_, std::move(data));
+    return lastID_;
+}
+
+std::shared_ptr<const ScheduleData> ScheduleInstances::Find(std::size_t id) const
+{
+    std::lock_guard lock(mutex_);
+    const auto it = instances_.find(id);
+    return it != instances_.end() ? it->second : nullptr;
+}
+
+bool ScheduleInstances::Remove(std::size_t id)
+{
+    std::lock_guard lock(mutex_);
+    return instances_.erase(id) != 0;
+}
+
+std::size_t ScheduleInstances::Count() const
+{
+    std::lock_guard lock(mutex_);
+    return instances_.size();
+}
@@ -0,0 +1,213 @@
+#include "ScheduleJobs.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+
+bool Finished(ScheduleJobStatus status)
+{
+    return status == ScheduleJobStatus::Done || status == ScheduleJobStatus::Failed
+           || status == ScheduleJobStatus::Cancelled;
+}
+
+ScheduleJobsManager::ScheduleJobsManager(ScheduleGA generator,
+                                         std::size_t workersCount,
+                                         std::size_t maxQueuedJobs,
+                                         std::size_t maxFinishedJobs)
+    : generator_(std::move(generator))
+    , maxQueuedJobs_(maxQueuedJobs)
+    , maxFinishedJobs_(maxFinishedJobs)
+{
+    if(workersCount < 1)
+        throw std::invalid_argument("Invalid workers count: at least 1 worker expected");
+
+    if(maxQueuedJobs_ < 1)
+        throw std::invalid_argument("Invalid max queued jobs count: must be greater than zero");
+
+    if(maxFinishedJobs_ < 1)
+        throw std::invalid_argument("Invalid max finished jobs count: must be greater than zero");
+
+    workers_.reserve(workersCount);
+    for(std::size_t i = 0; i < workersCount; ++i)
+        workers_.emplace_back([this](std::stop_token stopToken) { WorkerLoop(stopToken); });
+}
+
+ScheduleJobsManager::~ScheduleJobsManager()
+{
+    {
+        std::lock_guard lock(mutex_);
+        for(auto&& job : queue_)
+            job->Status = ScheduleJobStatus::Cancelled;
+
+        queue_.clear();
+        for(auto&& [id, job] : jobs_)
+            job->StopSource.request_stop();
+    }
+
+    // workers are stopped and joined before the jobs they may still reference are destroyed
+    workers_.clear();
+}
+
+std::optional<std::size_t> ScheduleJobsManager::Submit(ScheduleData data,
+                                                       std::optional<ScheduleResult> prior)
+{
+    return Submit(std::make_shared<const ScheduleData>(std::move(data)), std::move(prior));
+}
+
+std::optional<std::size_t> ScheduleJobsManager::Submit(std::shared_ptr<const ScheduleData> data,
+                                                       std::optional<ScheduleResult> prior)
+{
+    assert(data != nullptr);
+    std::lock_guard lock(mutex_);
+    if(queue_.size() >= maxQueuedJobs_)
+        return std::nullopt;
+
+    auto job = std::make_shared<Job>();
+    job->ID = ++lastID_;
+    job->Data = std::move(data);
+    job->Prior = std::move(prior);
+    jobs_.emplace(job->ID, job);
+    queue_.emplace_back(std::move(job));
+    jobsChanged_.notify_all();
+    return lastID_;
+}
+
+std::optional<ScheduleJobInfo> ScheduleJobsManager::Find(std::size_t id) const
+{
+    std::lock_guard lock(mutex_);
+    const auto it = jobs_.find(id);
+    if(it == jobs_.end())
+        return std::nullopt;
+
+    return MakeInfo(*it->second);
+}
+
+std::optional<ScheduleJobInfo> ScheduleJobsManager::Wait(std::size_t id) const
+{
+    std::unique_lock lock(mutex_);
+    const auto it = jobs_.find(id);
+    if(it == jobs_.end())
+        return std::nullopt;
+
+    // the job can be removed from the table while we are waiting
+    const std::shared_ptr<Job> job = it->second;
+    jobsChanged_.wait(lock, [&] { return Finished(job->Status); });
+    return MakeInfo(*job);
+}
+
+std::optional<ScheduleJobInfo> ScheduleJobsManager::Cancel(std::size_t id)
+{
+    std::lock_guard lock(mutex_);
+    const auto it = jobs_.find(id);
+    if(it == jobs_.end())
+        return std::nullopt;
+
+    Job& job = *it->second;
+    switch(job.Status)
+    {
+    case ScheduleJobStatus::Queued:
+        std::erase_if(queue_, [&](const std::shared_ptr<Job>& j) { return j->ID == id; });
+        job.Status = ScheduleJobStatus::Cancelled;
+        job.Progress.Finish(ScheduleGAStopReason::Cancelled);
+        jobsChanged_.notify_all();
+        {
+            // the job may be evicted right away, so the state is taken before
+            auto info = MakeInfo(job);
+            AddFinishedJob(id);
+            return info;
+        }
+
+    case ScheduleJobStatus::Running:
+        // the solve stops shortly and the worker completes the job
+        job.StopSource.request_stop();
+        return MakeInfo(job);
+
+    default:
+    {
+        auto info = MakeInfo(job);
+        std::erase(finishedJobs_, id);
+        jobs_.erase(it);
+        return info;
+    }
+    }
+}
+
+std::size_t ScheduleJobsManager::QueuedJobsCount() const
+{
+    std::lock_guard lock(mutex_);
+    return queue_.size();
+}
+
+void ScheduleJobsManager::WorkerLoop(std::stop_token stopToken)
+{
+    while(true)
+    {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock lock(mutex_);
+            if(!jobsChanged_.wait(lock, stopToken, [&] { return !queue_.empty(); }))
+                return;
+
+            job = std::move(queue_.front());
+            queue_.pop_front();
+            job->Status = ScheduleJobStatus::Running;
+        }
+
+        Run(*job);
+        Complete(job);
+    }
+}
+
+void ScheduleJobsManager::Run(Job& job)
+{
+    try
+    {
+        const std::stop_token stopToken = job.StopSource.get_token();
+        ScheduleResult result =
+            job.Prior ? Generate(generator_, *job.Data, *job.Prior, job.Progress, stopToken)
+                      : Generate(generator_, *job.Data, job.Progress, stopToken);
+        std::lock_guard lock(mutex_);
+        job.Result = std::move(result);
+    }
+    catch(std::exception& e)
+    {
+        std::lock_guard lock(mutex_);
+        job.Error = e.what();
+    }
+}
+
+void ScheduleJobsManager::Complete(const std::shared_ptr<Job>& job)
+{
+    std::lock_guard lock(mutex_);
+    if(!job->Error.empty())
+        job->Status = ScheduleJobStatus::Failed;
+    else if(job->Progress.Cancelled())
+        job->Status = ScheduleJobStatus::Cancelled;
+    else
+        job->Status = ScheduleJobStatus::Done;
+
+    AddFinishedJob(job->ID);
+    jobsChanged_.notify_all();
+}
+
+void ScheduleJobsManager::AddFinishedJob(std::size_t id)
+{
+    finishedJobs_.emplace_back(id);
+    while(finishedJobs_.size() > maxFinishedJobs_)
+    {
+        jobs_.erase(finishedJobs_.front());
+        finishedJobs_.pop_front();
+    }
+}
+
+ScheduleJobInfo ScheduleJobsManager::MakeInfo(const Job& job) const
+{
+    return ScheduleJobInfo{.ID = job.ID,
+                           .Status = job.Status,
+                           .Iteration = job.Progress.Iteration(),
+                           .BestEvaluation = job.Progress.BestEvaluation(),
+                           .StopReason = job.Progress.StopReason(),
+                           .Result = job.Result,
+                           .Error = job.Error};
+}
@@ -0,0 +1,188 @@
+#include "ScheduleJsonWriter.h"
+
+#include <cassert>
+#include <ostream>
+
+
+ScheduleJsonWriter::ScheduleJsonWriter(std::ostream& os, int indent)
+    : os_(os)
+    , indent_(indent)
+{
+}
+
+void ScheduleJsonWriter::BeginObject()
+{
+    Begin('{');
+}
+
+void ScheduleJsonWriter::EndObject()
+{
+    End('}');
+}
+
+void ScheduleJsonWriter::BeginArray()
+{
+    Begin('[');
+}
+
+void ScheduleJsonWriter::EndArray()
+{
+    End(']');
+}
+
+void ScheduleJsonWriter::Key(std::string_view key)
+{
+    assert(!afterKey_);
+    NextElement();
+    // the keys are the schema names, they don't need escaping
+    os_ << '"' << key << (indent_ < 0 ? "\":" : "\": ");
+    afterKey_ = true;
+}
+
+void ScheduleJsonWriter::Value(std::size_t value)
+{
+    BeforeValue();
+    os_ << value;
+}
+
+void ScheduleJsonWriter::Value(const std::vector<std::size_t>& values)
+{
+    BeginArray();
+    for(std::size_t value : values)
+        Value(value);
+
+    EndArray();
+}
+
+void ScheduleJsonWriter::Begin(char bracket)
+{
+    BeforeValue();
+    os_ << bracket;
+    emptyLevels_.push_back(true);
+}
+
+void ScheduleJsonWriter::End(char bracket)
+{
+    assert(!emptyLevels_.empty() && !afterKey_);
+    const bool empty = emptyLevels_.back();
+    emptyLevels_.pop_back();
+    if(!empty)
+        NewLine(emptyLevels_.size());
+
+    os_ << bracket;
+}
+
+void ScheduleJsonWriter::BeforeValue()
+{
+    if(afterKey_)
+        afterKey_ = false;
+    else if(!emptyLevels_.empty())
+        NextElement();
+}
+
+void ScheduleJsonWriter::NextElement()
+{
+    if(!emptyLevels_.back())
+        os_ << ',';
+
+    emptyLevels_.back() = false;
+    NewLine(emptyLevels_.size());
+}
+
+void ScheduleJsonWriter::NewLine(std::size_t level)
+{
+    if(indent_ < 0)
+        return;
+
+    os_ << '\n';
+    for(std::size_t i = 0; i < level * static_cast<std::size_t>(indent_); ++i)
+        os_ << ' ';
+}
+
+
+void WriteJson(std::ostream& os, const ScheduleResult& scheduleResult, int indent)
+{
+    ScheduleJsonWriter writer(os, indent);
+    writer.BeginArray();
+    for(auto&& item : scheduleResult.items())
+    {
+        writer.BeginObject();
+        writer.Key("address");
+        writer.Value(item.Address);
+        writer.Key("classroom");
+        writer.Value(item.Classroom);
+        writer.Key("subject_request_id");
+        writer.Value(item.SubjectRequestID);
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+}
+
+void WriteJson(std::ostream& os, const CheckScheduleResult& checkScheduleResult, int indent)
+{
+    ScheduleJsonWriter writer(os, indent);
+    writer.BeginObject();
+    writer.Key("out_of_block_requests");
+    writer.Value(checkScheduleResult.OutOfBlockRequests);
+
+    writer.Key("overlapped_classrooms");
+    writer.BeginArray();
+    for(auto&& overlapped : checkScheduleResult.OverlappedClassroomsList)
+    {
+        writer.BeginObject();
+        writer.Key("address");
+        writer.Value(overlapped.Address);
+        writer.Key("classroom");
+        writer.Value(overlapped.Classroom);
+        writer.Key("subject_ids");
+        writer.Value(overlapped.SubjectRequestsIDs);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.Key("overlapped_groups");
+    writer.BeginArray();
+    for(auto&& overlapped : checkScheduleResult.OverlappedGroupsList)
+    {
+        writer.BeginObject();
+        writer.Key("address");
+        writer.Value(overlapped.Address);
+        writer.Key("groups");
+        writer.Value(overlapped.Groups);
+        writer.Key("subject_ids");
+        writer.Value(overlapped.SubjectRequestsIDs);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.Key("overlapped_professors");
+    writer.BeginArray();
+    for(auto&& overlapped : checkScheduleResult.OverlappedProfessorsList)
+    {
+        writer.BeginObject();
+        writer.Key("address");
+        writer.Value(overlapped.Address);
+        writer.Key("professor");
+        writer.Value(overlapped.Professor);
+        writer.Key("subject_ids");
+        writer.Value(overlapped.SubjectRequestsIDs);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.Key("violated_lessons");
+    writer.BeginArray();
+    for(auto&& violated : checkScheduleResult.ViolatedLessons)
+    {
+        writer.BeginObject();
+        writer.Key("address");
+        writer.Value(violated.Address);
+        writer.Key("subject_id");
+        writer.Value(violated.SubjectRequestID);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+}
@@ -0,0 +1,281 @@
+#include "ScheduleMetrics.h"
+
+#include <algorithm>
+#include <charconv>
+#include <ostream>
+#include <string>
+#include <utility>
+
+
+constexpr std::array ENDPOINTS = {
+    std::pair{std::string_view{"makeSchedule"}, ScheduleEndpoint::MakeSchedule},
+    std::pair{std::string_view{"checkSchedule"}, ScheduleEndpoint::CheckSchedule},
+    std::pair{std::string_view{"jobs"}, ScheduleEndpoint::Jobs},
+    std::pair{std::string_view{"instances"}, ScheduleEndpoint::Instances},
+    std::pair{std::string_view{"sessions"}, ScheduleEndpoint::Sessions},
+    std::pair{std::string_view{"cacheStats"}, ScheduleEndpoint::CacheStats},
+    std::pair{std::string_view{"admissionStats"}, ScheduleEndpoint::AdmissionStats},
+    std::pair{std::string_view{"metrics"}, ScheduleEndpoint::Metrics}};
+static_assert(ENDPOINTS.size() == SCHEDULE_ENDPOINTS_COUNT);
+
+constexpr std::array<std::string_view, SCHEDULE_SOLVE_PHASES_COUNT> PHASES = {
+    "parse", "solve", "serialize"};
+
+std::optional<ScheduleEndpoint> FindScheduleEndpoint(std::string_view path)
+{
+    if(!path.starts_with('/'))
+        return std::nullopt;
+
+    // the collections are matched with their items: /jobs and /jobs/{id}
+    path.remove_prefix(1);
+    const std::string_view name = path.substr(0, path.find('/'));
+    const auto it = std::ranges::find(ENDPOINTS, name, &decltype(ENDPOINTS)::value_type::first);
+    if(it == ENDPOINTS.end())
+        return std::nullopt;
+
+    const bool collection = it->second == ScheduleEndpoint::Jobs
+                            || it->second == ScheduleEndpoint::Instances
+                            || it->second == ScheduleEndpoint::Sessions;
+    if(name.size() != path.size() && !collection)
+        return std::nullopt;
+
+    return it->second;
+}
+
+
+void ScheduleLatencyHistogram::Observe(std::chrono::steady_clock::duration duration)
+{
+    const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+    const double seconds = std::chrono::duration<double>(duration).count();
+    const auto bucket = static_cast<std::size_t>(std::ranges::lower_bound(BOUNDS, seconds)
+                                                 - BOUNDS.begin());
+    counts_.at(bucket).fetch_add(1, std::memory_order_relaxed);
+    sumMicroseconds_.fetch_add(static_cast<std::uint64_t>(microseconds.count()),
+                               std::memory_order_relaxed);
+}
+
+ScheduleHistogramSnapshot ScheduleLatencyHistogram::Snapshot() const
+{
+    ScheduleHistogramSnapshot snapshot;
+    snapshot.Counts.reserve(counts_.size());
+    for(auto&& count : counts_)
+    {
+        snapshot.Counts.emplace_back(count.load(std::memory_order_relaxed));
+        snapshot.Count += snapshot.Counts.back();
+    }
+
+    snapshot.Sum = std::chrono::microseconds(sumMicroseconds_.load(std::memory_order_relaxed));
+    return snapshot;
+}
+
+
+void ScheduleMetrics::RecordRequest(ScheduleEndpoint endpoint,
+                                    int status,
+                                    std::chrono::steady_clock::duration duration)
+{
+    auto& metrics = endpoints_.at(static_cast<std::size_t>(endpoint));
+    const int statusClass =
+        std::clamp(status / 100, 1, static_cast<int>(STATUS_CLASSES_COUNT));
+    metrics.Responses.at(static_cast<std::size_t>(statusClass - 1))
+        .fetch_add(1, std::memory_order_relaxed);
+    metrics.Latency.Observe(duration);
+}
+
+void ScheduleMetrics::RecordPhase(ScheduleSolvePhase phase,
+                                  std::chrono::steady_clock::duration duration)
+{
+    phases_.at(static_cast<std::size_t>(phase)).Observe(duration);
+}
+
+void ScheduleMetrics::RecordSolve(std::size_t iterations,
+                                  std::size_t bestEvaluation,
+                                  std::chrono::steady_clock::duration duration)
+{
+    const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+    const double seconds = std::chrono::duration<double>(duration).count();
+
+    solves_.fetch_add(1, std::memory_order_relaxed);
+    iterations_.fetch_add(iterations, std::memory_order_relaxed);
+    solveMicroseconds_.fetch_add(static_cast<std::uint64_t>(microseconds.count()),
+                                 std::memory_order_relaxed);
+    iterationsPerSecond_.store(seconds > 0.0 ? static_cast<double>(iterations) / seconds : 0.0,
+                               std::memory_order_relaxed);
+    bestEvaluation_.store(bestEvaluation, std::memory_order_relaxed);
+}
+
+// Shortest representation which is read back to the same value
+static void WriteNumber(std::ostream& os, double value)
+{
+    std::array<char, 32> buffer{};
+    const auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    os.write(buffer.data(), end - buffer.data());
+}
+
+static void WriteHeader(std::ostream& os,
+                        std::string_view name,
+                        std::string_view type,
+                        std::string_view help)
+{
+    os << "# HELP " << name << ' ' << help << '\n';
+    os << "# TYPE " << name << ' ' << type << '\n';
+}
+
+template<class Value>
+static void WriteMetric(std::ostream& os,
+                        std::string_view name,
+                        std::string_view type,
+                        std::string_view help,
+                        Value value)
+{
+    WriteHeader(os, name, type, help);
+    os << name << ' ';
+    WriteNumber(os, static_cast<double>(value));
+    os << '\n';
+}
+
+// Buckets of the histogram are cumulative in the exposition format
+static void WriteHistogram(std::ostream& os,
+                           std::string_view name,
+                           std::string_view labels,
+                           const ScheduleHistogramSnapshot& snapshot)
+{
+    std::uint64_t cumulativeCount = 0;
+    for(std::size_t i = 0; i < snapshot.Counts.size(); ++i)
+    {
+        cumulativeCount += snapshot.Counts[i];
+        os << name << "_bucket{" << labels << ",le=\"";
+        if(i < ScheduleLatencyHistogram::BOUNDS.size())
+            WriteNumber(os, ScheduleLatencyHistogram::BOUNDS[i]);
+        else
+            os << "+Inf";
+
+        os << "\"} " << cumulativeCount << '\n';
+    }
+
+    os << name << "_sum{" << labels << "} ";
+    WriteNumber(os, std::chrono::duration<double>(snapshot.Sum).count());
+    os << '\n';
+    os << name << "_count{" << labels << "} " << snapshot.Count << '\n';
+}
+
+void ScheduleMetrics::Write(std::ostream& os,
+                            const ScheduleAdmissionStats& admissionStats,
+                            const ScheduleCacheStats& cacheStats) const
+{
+    WriteHeader(os,
+                "schedule_http_requests_total",
+                "counter",
+                "Count of the HTTP requests by the endpoint and the status class.");
+    for(auto&& [name, endpoint] : ENDPOINTS)
+    {
+        const auto& metrics = endpoints_.at(static_cast<std::size_t>(endpoint));
+        for(std::size_t i = 0; i < metrics.Responses.size(); ++i)
+        {
+            os << "schedule_http_requests_total{endpoint=\"" << name << "\",code=\"" << i + 1
+               << "xx\"} " << metrics.Responses[i].load(std::memory_order_relaxed) << '\n';
+        }
+    }
+
+    WriteHeader(os,
+                "schedule_http_request_duration_seconds",
+                "histogram",
+                "Duration of the HTTP requests by the endpoint.");
+    for(auto&& [name, endpoint] : ENDPOINTS)
+    {
+        WriteHistogram(os,
+                       "schedule_http_request_duration_seconds",
+                       "endpoint=\"" + std::string(name) + '"',
+                       endpoints_.at(static_cast<std::size_t>(endpoint)).Latency.Snapshot());
+    }
+
+    WriteHeader(os,
+                "schedule_solve_phase_duration_seconds",
+                "histogram",
+                "Duration of the phases of the /makeSchedule requests.");
+    for(std::size_t i = 0; i < PHASES.size(); ++i)
+    {
+        WriteHistogram(os,
+                       "schedule_solve_phase_duration_seconds",
+                       "phase=\"" + std::string(PHASES[i]) + '"',
+                       phases_[i].Snapshot());
+    }
+
+    const auto solveMicroseconds =
+        std::chrono::microseconds(solveMicroseconds_.load(std::memory_order_relaxed));
+    WriteMetric(os,
+                "schedule_ga_solves_total",
+                "counter",
+                "Count of the finished solves.",
+                solves_.load(std::memory_order_relaxed));
+    WriteMetric(os,
+                "schedule_ga_iterations_total",
+                "counter",
+                "Count of the GA iterations of the finished solves.",
+                iterations_.load(std::memory_order_relaxed));
+    WriteMetric(os,
+                "schedule_ga_solve_seconds_total",
+                "counter",
+                "Time spent by the finished solves.",
+                std::chrono::duration<double>(solveMicroseconds).count());
+    WriteMetric(os,
+                "schedule_ga_iterations_per_second",
+                "gauge",
+                "GA iterations per second of the last solve.",
+                iterationsPerSecond_.load(std::memory_order_relaxed));
+    if(const std::size_t bestEvaluation = bestEvaluation_.load(std::memory_order_relaxed);
+       bestEvaluation != NOT_EVALUATED)
+    {
+        WriteMetric(os,
+                    "schedule_ga_best_evaluation",
+                    "gauge",
+                    "Cost of the best schedule of the last solve.",
+                    bestEvaluation);
+    }
+
+    WriteMetric(os,
+                "schedule_active_solves",
+                "gauge",
+                "Count of the running solves.",
+                admissionStats.ActiveCount);
+    WriteMetric(os,
+                "schedule_queued_solves",
+                "gauge",
+                "Count of the solves waiting for the free slot.",
+                admissionStats.QueuedCount);
+    WriteMetric(os,
+                "schedule_admitted_solves_total",
+                "counter",
+                "Count of the admitted solves.",
+                admissionStats.Admitted);
+    WriteMetric(os,
+                "schedule_rejected_solves_total",
+                "counter",
+                "Count of the solves rejected because the queue is full.",
+                admissionStats.Rejected);
+
+    WriteMetric(os,
+                "schedule_cache_hits_total",
+                "counter",
+                "Count of the solves found in the results cache.",
+                cacheStats.Hits);
+    WriteMetric(os,
+                "schedule_cache_misses_total",
+                "counter",
+                "Count of the solves not found in the results cache.",
+                cacheStats.Misses);
+    WriteMetric(os,
+                "schedule_cache_entries",
+                "gauge",
+                "Count of the results in the cache.",
+                cacheStats.EntriesCount);
+    WriteMetric(os,
+                "schedule_cache_size_bytes",
+                "gauge",
+                "Memory used by the results in the cache.",
+                cacheStats.Size);
+    WriteMetric(os,
+                "schedule_cache_capacity_bytes",
+                "gauge",
+                "Memory budget of the results cache.",
+                cacheStats.Capacity);
+}
@@ -0,0 +1,55 @@
+#include "ScheduleProgressStream.h"
+
+#include <charconv>
+#include <ostream>
+#include <stdexcept>
+
+
+bool ParseBoolParameter(const std::string& value)
+{
+    if(value.empty() || value == "1" || value == "true")
+        return true;
+
+    if(value == "0" || value == "false")
+        return false;
+
+    throw std::invalid_argument("Invalid boolean query parameter: '" + value + "'");
+}
+
+std::optional<ScheduleProgressStreamOptions>
+    ParseProgressStreamOptions(std::string_view accept, const ScheduleQueryParameters& parameters)
+{
+    bool stream = accept.find("text/event-stream") != std::string_view::npos;
+    ScheduleProgressStreamOptions options;
+    for(auto&& [name, value] : parameters)
+    {
+        if(name == "stream")
+        {
+            stream = ParseBoolParameter(value);
+        }
+        else if(name == "progress_interval")
+        {
+            const auto [ptr, ec] =
+                std::from_chars(value.data(), value.data() + value.size(), options.Interval);
+            if(ec != std::errc{} || ptr != value.data() + value.size() || options.Interval == 0)
+                throw std::invalid_argument("Invalid progress_interval: positive number expected");
+        }
+        else if(name == "with_schedule")
+        {
+            options.WithSchedule = ParseBoolParameter(value);
+        }
+    }
+
+    if(!stream)
+        return std::nullopt;
+
+    return options;
+}
+
+void WriteEvent(std::ostream& os, std::string_view event, const nlohmann::json& data)
+{
+    // the status is sent already, so the event can't fail on the invalid UTF-8 of the error
+    os << "event: " << event << "\ndata: "
+       << data.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace) << "\n\n"
+       << std::flush;
+}
@@ -1,39 +1,383 @@
 #include "ScheduleRequestHandler.h"
 #include "ScheduleDataSerialization.h"
+#include "ScheduleJsonWriter.h"
 #include "ScheduleServer.h"
 #include "ScheduleValidation.h"
+#include "ScheduleWireFormat.h"
 
+#include <Poco/DeflatingStream.h>
+#include <Poco/InflatingStream.h>
+#include <Poco/Net/HTTPServerRequestImpl.h>
+#include <Poco/Net/StreamSocket.h>
 #include <Poco/URI.h>
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <optional>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <tuple>
 
 
 using namespace Poco;
 using namespace Poco::Net;
 
 
-MakeScheduleRequestHandler::MakeScheduleRequestHandler(ScheduleGA generator, std::shared_ptr<spdlog::logger> logger)
+// the watcher checks its stop token between the polls, so it is joined without delay
+constexpr long CLIENT_POLL_INTERVAL_MS = 10;
+
+// Once the client has sent the next request, its data keeps the socket readable
+// until the response is sent, so only the errors of the socket are polled then
+static bool ClientDisconnected(StreamSocket& socket, int& selectMode)
+{
+    try
+    {
+        if(!socket.poll(Timespan(0, CLIENT_POLL_INTERVAL_MS * 1000), selectMode))
+            return false;
+
+        if((selectMode & Socket::SELECT_READ) == 0)
+            return true;
+
+        // readable socket without data means that the client has closed the connection
+        char buffer = 0;
+        if(socket.receiveBytes(&buffer, 1, MSG_PEEK) == 0)
+            return true;
+
+        selectMode = Socket::SELECT_ERROR;
+        return false;
+    }
+    catch(std::exception&)
+    {
+        return true;
+    }
+}
+
+// Watches the client connection on its own thread while the request is processed
+// and requests the stop when the client disconnects
+class ClientDisconnectWatcher
+{
+public:
+    ClientDisconnectWatcher(HTTPServerRequest& request, std::stop_source stopSource)
+    {
+        auto* requestImpl = dynamic_cast<HTTPServerRequestImpl*>(&request);
+        if(requestImpl == nullptr)
+            return;
+
+        thread_ = std::jthread(
+            [&socket = requestImpl->socket(), stopSource](std::stop_token watcherToken) mutable
+            {
+                int selectMode = Socket::SELECT_READ | Socket::SELECT_ERROR;
+                while(!watcherToken.stop_requested())
+                {
+                    if(ClientDisconnected(socket, selectMode))
+                    {
+                        stopSource.request_stop();
+                        return;
+                    }
+                }
+            });
+    }
+
+private:
+    std::jthread thread_;
+};
+
+constexpr auto PROGRESS_POLL_INTERVAL = std::chrono::milliseconds{50};
+
+// Request and response bodies are encoded by the negotiated format and content coding.
+// The schedule data of the request is read by the streaming parser while the body is inflated,
+// the rest of the body is stored to jsonRequest.
+static std::optional<ScheduleData> ReadRequestData(HTTPServerRequest& request,
+                                                   nlohmann::json& jsonRequest)
+{
+    const ScheduleWireFormat format = RequestWireFormat(request.getContentType());
+    const std::string& contentEncoding = request.get("Content-Encoding", "");
+    const auto encoding = RequestContentEncoding(contentEncoding);
+    if(!encoding)
+        throw std::invalid_argument("Unsupported Content-Encoding: '" + contentEncoding + "'");
+
+    if(*encoding == ScheduleContentEncoding::Identity)
+        return ReadScheduleData(request.stream(), InputFormat(format), jsonRequest);
+
+    InflatingInputStream inflating(request.stream(),
+                                   *encoding == ScheduleContentEncoding::Gzip
+                                       ? InflatingStreamBuf::STREAM_GZIP
+                                       : InflatingStreamBuf::STREAM_ZLIB);
+    return ReadScheduleData(inflating, InputFormat(format), jsonRequest);
+}
+
+struct ResponseEncoding
+{
+    ScheduleWireFormat Format = ScheduleWireFormat::Json;
+    ScheduleContentEncoding ContentEncoding = ScheduleContentEncoding::Identity;
+    // shorter bodies are not compressed
+    std::size_t CompressionMinSize = 0;
+    // JSON is compact if it is negative
+    int Indent = -1;
+};
+
+static ResponseEncoding NegotiateResponseEncoding(const HTTPServerRequest& request,
+                                                  std::size_t compressionMinSize)
+{
+    return ResponseEncoding{
+        .Format = ResponseWireFormat(request.get("Accept", "")),
+        .ContentEncoding = ResponseContentEncoding(request.get("Accept-Encoding", "")),
+        .CompressionMinSize = compressionMinSize};
+}
+
+// The body is compressed on the fly if the client accepts it and the body is not too short
+static void SendBody(HTTPServerResponse& response,
+                     const ResponseEncoding& encoding,
+                     const std::function<void(std::ostream&)>& write)
+{
+    response.setContentType(std::string(ContentType(encoding.Format)));
+    if(encoding.ContentEncoding == ScheduleContentEncoding::Identity)
+    {
+        response.setChunkedTransferEncoding(true);
+        std::ostream& out = response.send();
+        write(out);
+        out << std::flush;
+        return;
+    }
+
+    response.set("Vary", "Accept-Encoding");
+    std::ostream* out = nullptr;
+    std::optional<DeflatingOutputStream> deflating;
+    ScheduleBodyBuffer buffer(
+        encoding.CompressionMinSize,
+        [&](std::optional<std::size_t> bodySize) -> std::ostream&
+        {
+            if(bodySize)
+            {
+                response.setContentLength(static_cast<std::streamsize>(*bodySize));
+                out = &response.send();
+                return *out;
+            }
+
+            response.setChunkedTransferEncoding(true);
+            response.set("Content-Encoding",
+                         std::string(ContentEncodingName(encoding.ContentEncoding)));
+            out = &response.send();
+            return deflating.emplace(*out,
+                                     encoding.ContentEncoding == ScheduleContentEncoding::Gzip
+                                         ? DeflatingStreamBuf::STREAM_GZIP
+                                         : DeflatingStreamBuf::STREAM_ZLIB);
+        });
+
+    std::ostream bufferStream(&buffer);
+    write(bufferStream);
+    buffer.Finish();
+    if(deflating)
+        deflating->close();
+
+    *out << std::flush;
+}
+
+static void SendResponseBody(HTTPServerResponse& response,
+                             const nlohmann::json& body,
+                             const ResponseEncoding& encoding)
+{
+    SendBody(response,
+             encoding,
+             [&](std::ostream& out) { WriteBody(out, body, encoding.Format, encoding.Indent); });
+}
+
+// Results are written to the response without the DOM if JSON is negotiated
+template<typename Result>
+static void SendResult(HTTPServerResponse& response,
+                       const Result& result,
+                       const ResponseEncoding& encoding)
+{
+    if(encoding.Format != ScheduleWireFormat::Json)
+    {
+        SendResponseBody(response, result, encoding);
+        return;
+    }
+
+    SendBody(response,
+             encoding,
+             [&](std::ostream& out) { WriteJson(out, result, encoding.Indent); });
+}
+
+constexpr int PRETTY_JSON_INDENT = 4;
+
+// Responses are compact unless the "pretty" query parameter is set
+static int ParseResponseIndent(const URI& uri)
+{
+    for(auto&& [name, value] : uri.getQueryParameters())
+    {
+        if(name == "pretty")
+            return ParseBoolParameter(value) ? PRETTY_JSON_INDENT : -1;
+    }
+
+    return -1;
+}
+
+static const std::string OVERLOADED_ERROR = "Too many solves are running, retry later";
+
+// 503 with the expected time until the new solve could be admitted
+static void SetOverloadedStatus(HTTPServerResponse& response, const ScheduleAdmission& admission)
+{
+    response.setStatus(HTTPResponse::HTTP_SERVICE_UNAVAILABLE);
+    response.set("Retry-After", std::to_string(admission.RetryAfter().count()));
+}
+
+static ScheduleData RequireScheduleData(std::optional<ScheduleData> data)
+{
+    if(!data)
+        throw std::invalid_argument("'subject_requests' array expected");
+
+    return std::move(*data);
+}
+
+// Data of the registered instance referenced by the "instance" key or read from the body
+static std::shared_ptr<const ScheduleData> FindScheduleData(std::optional<ScheduleData> data,
+                                                            const nlohmann::json& jsonRequest,
+                                                            const ScheduleInstances& instances)
+{
+    const auto it = jsonRequest.find("instance");
+    if(it == jsonRequest.end())
+        return std::make_shared<const ScheduleData>(RequireScheduleData(std::move(data)));
+
+    const auto id = it->get<std::size_t>();
+    auto instanceData = instances.Find(id);
+    if(instanceData == nullptr)
+        throw std::out_of_range("Instance with ID=" + std::to_string(id) + " is not found!");
+
+    return instanceData;
+}
+
+
+MakeScheduleRequestHandler::MakeScheduleRequestHandler(
+    ScheduleGA generator,
+    std::shared_ptr<ScheduleInstances> instances,
+    std::shared_ptr<ScheduleResultCache> resultCache,
+    std::shared_ptr<ScheduleSolveFlights> solveFlights,
+    std::shared_ptr<ScheduleAdmission> admission,
+    std::shared_ptr<ScheduleMetrics> metrics,
+    std::size_t compressionMinSize,
+    std::shared_ptr<spdlog::logger> logger)
     : logger_{std::move(logger)}
     , generator_{std::move(generator)}
+    , instances_{std::move(instances)}
+    , resultCache_{std::move(resultCache)}
+    , solveFlights_{std::move(solveFlights)}
+    , admission_{std::move(admission)}
+    , metrics_{std::move(metrics)}
+    , compressionMinSize_{compressionMinSize}
 {
     assert(logger_ != nullptr);
+    assert(instances_ != nullptr);
+    assert(resultCache_ != nullptr);
+    assert(solveFlights_ != nullptr);
+    assert(admission_ != nullptr);
+    assert(metrics_ != nullptr);
 }
 
 void MakeScheduleRequestHandler::handleRequest(Poco::Net::HTTPServerRequest& request,
                                                Poco::Net::HTTPServerResponse& response)
 {
+    ResponseEncoding responseEncoding = NegotiateResponseEncoding(request, compressionMinSize_);
     nlohmann::json jsonResponse;
     try
     {
+        const auto parseStart = std::chrono::steady_clock::now();
+        const URI uri{request.getURI()};
+        responseEncoding.Indent = ParseResponseIndent(uri);
+        const auto streamOptions =
+            ParseProgressStreamOptions(request.get("Accept", ""), uri.getQueryParameters());
+
         nlohmann::json jsonRequest;
-        request.stream() >> jsonRequest;
+        auto requestData = ReadRequestData(request, jsonRequest);
+        const auto pData = FindScheduleData(std::move(requestData), jsonRequest, *instances_);
+        const ScheduleData& data = *pData;
+        const std::optional<ScheduleResult> prior = ParsePriorSchedule(jsonRequest);
+        metrics_->RecordPhase(ScheduleSolvePhase::Parse,
+                              std::chrono::steady_clock::now() - parseStart);
+        const ScheduleCacheKey cacheKey =
+            prior ? MakeScheduleCacheKey(data, generator_.Params(), *prior)
+                  : MakeScheduleCacheKey(data, generator_.Params());
+        if(streamOptions)
+        {
+            StreamSchedule(request, response, data, prior, cacheKey, *streamOptions);
+            return;
+        }
 
-        logger_->info("Start generate schedule...");
-        jsonResponse = Generate(generator_, jsonRequest);
-        logger_->info(
-            "Schedule done: requests: {}, responses: {}", jsonRequest.size(), jsonResponse.size());
+        if(const auto cachedResult = resultCache_->Find(cacheKey))
+        {
+            logger_->info("Schedule is found in the cache");
+            response.set("X-Schedule-Cache", "hit");
+            response.setStatus(HTTPResponse::HTTP_OK);
+            const auto serializeStart = std::chrono::steady_clock::now();
+            SendResult(response, *cachedResult, responseEncoding);
+            metrics_->RecordPhase(ScheduleSolvePhase::Serialize,
+                                  std::chrono::steady_clock::now() - serializeStart);
+            return;
+        }
 
+        std::shared_ptr<ScheduleSolveFlight> flight;
+        bool leader = false;
+        std::tie(flight, leader) = solveFlights_->Join(cacheKey);
+
+        std::stop_source clientStop;
+        {
+            const ClientDisconnectWatcher watcher(request, clientStop);
+            const std::stop_callback leave(clientStop.get_token(), [&] { flight->Leave(); });
+            if(leader)
+            {
+                logger_->info(prior ? "Start generate schedule from the prior one..."
+                                    : "Start generate schedule...");
+                RunSolve(data, prior, cacheKey, flight);
+            }
+            else
+            {
+                logger_->info("Wait for the running generation of the same schedule...");
+                flight->Wait(clientStop.get_token());
+            }
+        }
+
+        if(!flight->Completed())
+            throw std::runtime_error("Client has disconnected");
+
+        const ScheduleSolveOutcome& outcome = flight->Outcome();
+        if(outcome.Rejected)
+        {
+            logger_->warn("Schedule generation is rejected: too many solves");
+            SetOverloadedStatus(response, *admission_);
+            SendResponseBody(response, nlohmann::json{{"error", outcome.Error}}, responseEncoding);
+            return;
+        }
+
+        if(outcome.Result == nullptr)
+            throw std::runtime_error(outcome.Error);
+
+        const ScheduleResult& result = *outcome.Result;
+        const ScheduleGAProgress& progress = flight->Progress();
+        if(progress.Cancelled())
+            logger_->warn("Schedule generation is cancelled: the client has disconnected");
+
+        const nlohmann::json jsonStopReason = *progress.StopReason();
+        logger_->info("Schedule done: requests: {}, responses: {}, iterations: {}, stop reason: {}",
+                      data.SubjectRequests().size(),
+                      result.items().size(),
+                      progress.Iteration(),
+                      jsonStopReason.get<std::string>());
+
+        response.set("X-Schedule-Iterations", std::to_string(progress.Iteration()));
+        response.set("X-Schedule-Stop-Reason", jsonStopReason.get<std::string>());
+        response.set("X-Schedule-Cache", leader ? "miss" : "shared");
+        response.set("X-Schedule-Queue-Wait", std::to_string(outcome.QueueWait.count()));
         response.setStatus(HTTPResponse::HTTP_OK);
+        const auto serializeStart = std::chrono::steady_clock::now();
+        SendResult(response, result, responseEncoding);
+        metrics_->RecordPhase(ScheduleSolvePhase::Serialize,
+                              std::chrono::steady_clock::now() - serializeStart);
+        return;
     }
     catch(std::exception& e)
     {
@@ -41,22 +385,488 @@ void MakeScheduleRequestHandler::handleRequest(Poco::Net::HTTPServerRequest& req
         response.setStatus(HTTPResponse::HTTP_BAD_REQUEST);
     }
 
-    response.setContentType("text/json");
-    response.send() << jsonResponse.dump(4) << std::flush;
+    SendResponseBody(response, jsonResponse, responseEncoding);
 }
 
+void MakeScheduleRequestHandler::RunSolve(const ScheduleData& data,
+                                          const std::optional<ScheduleResult>& prior,
+                                          const ScheduleCacheKey& cacheKey,
+                                          const std::shared_ptr<ScheduleSolveFlight>& flight)
+{
+    const auto solveStart = std::chrono::steady_clock::now();
+    ScheduleSolveOutcome outcome;
+    try
+    {
+        // the slot is released before the waiting requests get the outcome
+        if(const auto permit = admission_->Acquire(flight->StopToken()))
+        {
+            outcome.QueueWait = permit->QueueWait();
+            const auto generateStart = std::chrono::steady_clock::now();
+            auto result = std::make_shared<const ScheduleResult>(
+                prior ? Generate(generator_, data, *prior, flight->Progress(), flight->StopToken())
+                      : Generate(generator_, data, flight->Progress(), flight->StopToken()));
+            const auto solveEnd = std::chrono::steady_clock::now();
+            metrics_->RecordSolve(flight->Progress().Iteration(),
+                                  flight->Progress().BestEvaluation(),
+                                  solveEnd - generateStart);
+            metrics_->RecordPhase(ScheduleSolvePhase::Solve, solveEnd - solveStart);
+            if(!flight->Progress().Cancelled())
+                resultCache_->Insert(cacheKey, result);
+
+            outcome.Result = std::move(result);
+        }
+        else if(flight->StopRequested())
+        {
+            outcome.Error = "Schedule generation is cancelled while waiting in the queue";
+        }
+        else
+        {
+            outcome.Rejected = true;
+            outcome.Error = OVERLOADED_ERROR;
+        }
+    }
+    catch(std::exception& e)
+    {
+        outcome.Error = e.what();
+    }
+
+    // later requests hit the cache or start a new solve, the waiting ones get this outcome
+    solveFlights_->Finish(cacheKey, flight);
+    flight->Complete(std::move(outcome));
+}
+
+void MakeScheduleRequestHandler::StreamSchedule(Poco::Net::HTTPServerRequest& request,
+                                                Poco::Net::HTTPServerResponse& response,
+                                                const ScheduleData& data,
+                                                const std::optional<ScheduleResult>& prior,
+                                                const ScheduleCacheKey& cacheKey,
+                                                const ScheduleProgressStreamOptions& options)
+{
+    response.setChunkedTransferEncoding(true);
+    response.setContentType("text/event-stream");
+    response.set("Cache-Control", "no-cache");
+    response.setStatus(HTTPResponse::HTTP_OK);
+    std::ostream& out = response.send();
+
+    // the status and the headers are sent, so the errors are reported by the event.
+    // The future waits for the solve, so the solve is stopped before the future is destroyed.
+    std::shared_ptr<ScheduleSolveFlight> flight;
+    bool leader = false;
+    std::stop_source clientStop;
+    std::optional<std::stop_callback<std::function<void()>>> leave;
+    // the solve runs aside, this thread reports its progress until it is finished
+    std::future<void> solve;
+    try
+    {
+        if(const auto cachedResult = resultCache_->Find(cacheKey))
+        {
+            logger_->info("Schedule is found in the cache");
+            WriteEvent(out, "result", {{"cached", true}, {"schedule", *cachedResult}});
+            return;
+        }
+
+        std::tie(flight, leader) = solveFlights_->Join(cacheKey);
+        leave.emplace(clientStop.get_token(), [&] { flight->Leave(); });
+        const ClientDisconnectWatcher watcher(request, clientStop);
+        if(leader)
+        {
+            logger_->info("Start generate schedule with progress streaming...");
+            solve = std::async(std::launch::async,
+                               [&] { RunSolve(data, prior, cacheKey, flight); });
+        }
+        else
+        {
+            logger_->info("Stream progress of the running generation of the same schedule...");
+        }
+
+        ScheduleGAProgress& progress = flight->Progress();
+        std::size_t reportedIteration = 0;
+        while(!flight->WaitFor(PROGRESS_POLL_INTERVAL))
+        {
+            if(clientStop.stop_requested())
+            {
+                // the leader has to complete the flight for the others
+                if(!leader)
+                    return;
+
+                continue;
+            }
+
+            const std::size_t iteration = progress.Iteration();
+            if(iteration < reportedIteration + options.Interval)
+                continue;
+
+            nlohmann::json jsonProgress = {{"iteration", iteration},
+                                           {"best_evaluation", progress.BestEvaluation()}};
+            if(options.WithSchedule)
+            {
+                if(const auto best = progress.BestIndividual())
+                    jsonProgress["schedule"] = MakeScheduleResult(best->Chromosomes(), data);
+            }
+
+            WriteEvent(out, "progress", jsonProgress);
+            reportedIteration = iteration;
+
+            // the client can't receive updates anymore, so it doesn't need the result
+            if(!out)
+                clientStop.request_stop();
+        }
+
+        const ScheduleSolveOutcome& outcome = flight->Outcome();
+        if(outcome.Result == nullptr)
+        {
+            WriteEvent(out, "error", {{"error", outcome.Error}});
+            return;
+        }
+
+        if(progress.Cancelled())
+            logger_->warn("Schedule generation is cancelled: the client has disconnected");
+
+        logger_->info("Schedule done: iterations: {}, stop reason: {}",
+                      progress.Iteration(),
+                      nlohmann::json(*progress.StopReason()).get<std::string>());
+
+        WriteEvent(out,
+                   "result",
+                   {{"iteration", progress.Iteration()},
+                    {"best_evaluation", progress.BestEvaluation()},
+                    {"stop_reason", *progress.StopReason()},
+                    {"cached", false},
+                    {"shared", !leader},
+                    {"schedule", *outcome.Result}});
+    }
+    catch(std::exception& e)
+    {
+        logger_->error("Schedule progress streaming is failed: {}", e.what());
+        clientStop.request_stop();
+        WriteEvent(out, "error", {{"error", e.what()}});
+    }
+}
+
+
+CheckScheduleRequestHandler::CheckScheduleRequestHandler(
+    std::shared_ptr<ScheduleInstances> instances, std::size_t compressionMinSize)
+    : instances_{std::move(instances)}
+    , compressionMinSize_{compressionMinSize}
+{
+    assert(instances_ != nullptr);
+}
 
 void CheckScheduleRequestHandler::handleRequest(Poco::Net::HTTPServerRequest& request,
                                                 Poco::Net::HTTPServerResponse& response)
 {
+    ResponseEncoding responseEncoding = NegotiateResponseEncoding(request, compressionMinSize_);
     nlohmann::json jsonResponse;
     try
     {
-        nlohmann::json jsonRequest;
-        request.stream() >> jsonRequest;
+        responseEncoding.Indent = ParseResponseIndent(URI{request.getURI()});
 
-        jsonResponse = CheckSchedule(jsonRequest, jsonRequest.at("placed_lessons"));
+        nlohmann::json jsonRequest;
+        auto requestData = ReadRequestData(request, jsonRequest);
+        const auto data = FindScheduleData(std::move(requestData), jsonRequest, *instances_);
+        const CheckScheduleResult result =
+            CheckSchedule(*data, jsonRequest.at("placed_lessons").get<ScheduleResult>());
         response.setStatus(HTTPResponse::HTTP_OK);
+        SendResult(response, result, responseEncoding);
+        return;
+    }
+    catch(std::exception& e)
+    {
+        jsonResponse = {{"error", e.what()}};
+        response.setStatus(HTTPResponse::HTTP_BAD_REQUEST);
+    }
+
+    SendResponseBody(response, jsonResponse, responseEncoding);
+}
+
+
+ScheduleOverloadedRequestHandler::ScheduleOverloadedRequestHandler(
+    std::shared_ptr<ScheduleAdmission> admission)
+    : admission_{std::move(admission)}
+{
+    assert(admission_ != nullptr);
+}
+
+void ScheduleOverloadedRequestHandler::handleRequest(Poco::Net::HTTPServerRequest&,
+                                                     Poco::Net::HTTPServerResponse& response)
+{
+    const nlohmann::json jsonResponse = {{"error", OVERLOADED_ERROR}};
+    SetOverloadedStatus(response, *admission_);
+    response.setContentType("text/json");
+    response.send() << jsonResponse.dump(4) << std::flush;
+}
+
+
+AdmissionStatsRequestHandler::AdmissionStatsRequestHandler(
+    std::shared_ptr<ScheduleAdmission> admission)
+    : admission_{std::move(admission)}
+{
+    assert(admission_ != nullptr);
+}
+
+void AdmissionStatsRequestHandler::handleRequest(Poco::Net::HTTPServerRequest&,
+                                                 Poco::Net::HTTPServerResponse& response)
+{
+    const nlohmann::json jsonResponse = admission_->Stats();
+    response.setStatus(HTTPResponse::HTTP_OK);
+    response.setContentType("text/json");
+    response.send() << jsonResponse.dump(4) << std::flush;
+}
+
+
+CacheStatsRequestHandler::CacheStatsRequestHandler(std::shared_ptr<ScheduleResultCache> resultCache)
+    : resultCache_{std::move(resultCache)}
+{
+    assert(resultCache_ != nullptr);
+}
+
+void CacheStatsRequestHandler::handleRequest(Poco::Net::HTTPServerRequest&,
+                                             Poco::Net::HTTPServerResponse& response)
+{
+    const nlohmann::json jsonResponse = resultCache_->Stats();
+    response.setStatus(HTTPResponse::HTTP_OK);
+    response.setContentType("text/json");
+    response.send() << jsonResponse.dump(4) << std::flush;
+}
+
+
+MetricsRequestHandler::MetricsRequestHandler(std::shared_ptr<ScheduleMetrics> metrics,
+                                             std::shared_ptr<ScheduleAdmission> admission,
+                                             std::shared_ptr<ScheduleResultCache> resultCache)
+    : metrics_{std::move(metrics)}
+    , admission_{std::move(admission)}
+    , resultCache_{std::move(resultCache)}
+{
+    assert(metrics_ != nullptr);
+    assert(admission_ != nullptr);
+    assert(resultCache_ != nullptr);
+}
+
+void MetricsRequestHandler::handleRequest(Poco::Net::HTTPServerRequest&,
+                                          Poco::Net::HTTPServerResponse& response)
+{
+    response.setStatus(HTTPResponse::HTTP_OK);
+    response.setContentType("text/plain; version=0.0.4");
+    std::ostream& out = response.send();
+    metrics_->Write(out, admission_->Stats(), resultCache_->Stats());
+    out << std::flush;
+}
+
+
+MeteredRequestHandler::MeteredRequestHandler(std::unique_ptr<HTTPRequestHandler> handler,
+                                             ScheduleEndpoint endpoint,
+                                             std::shared_ptr<ScheduleMetrics> metrics)
+    : handler_{std::move(handler)}
+    , endpoint_{endpoint}
+    , metrics_{std::move(metrics)}
+{
+    assert(handler_ != nullptr);
+    assert(metrics_ != nullptr);
+}
+
+void MeteredRequestHandler::handleRequest(Poco::Net::HTTPServerRequest& request,
+                                          Poco::Net::HTTPServerResponse& response)
+{
+    const auto start = std::chrono::steady_clock::now();
+    try
+    {
+        handler_->handleRequest(request, response);
+    }
+    catch(...)
+    {
+        metrics_->RecordRequest(endpoint_,
+                                HTTPResponse::HTTP_INTERNAL_SERVER_ERROR,
+                                std::chrono::steady_clock::now() - start);
+        throw;
+    }
+
+    metrics_->RecordRequest(
+        endpoint_, response.getStatus(), std::chrono::steady_clock::now() - start);
+}
+
+
+static const std::string JOBS_PATH = "/jobs";
+
+static std::optional<std::size_t> ParseID(std::string_view str)
+{
+    std::size_t id = 0;
+    const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), id);
+    if(ec != std::errc{} || ptr != str.data() + str.size())
+        return std::nullopt;
+
+    return id;
+}
+
+static std::optional<std::size_t> ParseJobID(const std::string& path)
+{
+    // path is expected to be "/jobs/{id}"
+    if(!path.starts_with(JOBS_PATH + '/'))
+        return std::nullopt;
+
+    return ParseID(std::string_view(path).substr(JOBS_PATH.size() + 1));
+}
+
+ScheduleJobsRequestHandler::ScheduleJobsRequestHandler(std::shared_ptr<ScheduleJobsManager> jobs,
+                                                       std::shared_ptr<ScheduleInstances> instances,
+                                                       std::shared_ptr<spdlog::logger> logger)
+    : jobs_{std::move(jobs)}
+    , instances_{std::move(instances)}
+    , logger_{std::move(logger)}
+{
+    assert(jobs_ != nullptr);
+    assert(instances_ != nullptr);
+    assert(logger_ != nullptr);
+}
+
+void ScheduleJobsRequestHandler::handleRequest(Poco::Net::HTTPServerRequest& request,
+                                               Poco::Net::HTTPServerResponse& response)
+{
+    nlohmann::json jsonResponse;
+    try
+    {
+        const URI uri{request.getURI()};
+        const std::string& method = request.getMethod();
+        if(uri.getPath() == JOBS_PATH && method == HTTPRequest::HTTP_POST)
+        {
+            nlohmann::json jsonRequest;
+            auto requestData = ReadRequestData(request, jsonRequest);
+
+            const auto id =
+                jobs_->Submit(FindScheduleData(std::move(requestData), jsonRequest, *instances_),
+                              ParsePriorSchedule(jsonRequest));
+            if(id)
+            {
+                logger_->info("Job {} is queued", *id);
+                jsonResponse = {{"id", *id}, {"status", ScheduleJobStatus::Queued}};
+                response.set("Location", JOBS_PATH + '/' + std::to_string(*id));
+                response.setStatus(HTTPResponse::HTTP_ACCEPTED);
+            }
+            else
+            {
+                logger_->warn("Job is rejected: the jobs queue is full");
+                jsonResponse = {{"error", "Too many queued jobs"}};
+                response.setStatus(HTTPResponse::HTTP_SERVICE_UNAVAILABLE);
+            }
+        }
+        else if(const auto id = ParseJobID(uri.getPath());
+                id && (method == HTTPRequest::HTTP_GET || method == HTTPRequest::HTTP_DELETE))
+        {
+            const bool cancel = method == HTTPRequest::HTTP_DELETE;
+            const auto jobInfo = cancel ? jobs_->Cancel(*id) : jobs_->Find(*id);
+            if(jobInfo)
+            {
+                if(cancel)
+                    logger_->info("Job {} is cancelled", *id);
+
+                jsonResponse = *jobInfo;
+                response.setStatus(HTTPResponse::HTTP_OK);
+            }
+            else
+            {
+                jsonResponse = {{"error", "Job is not found"}};
+                response.setStatus(HTTPResponse::HTTP_NOT_FOUND);
+            }
+        }
+        else
+        {
+            jsonResponse = {{"error", "Unsupported jobs request"}};
+            response.setStatus(HTTPResponse::HTTP_METHOD_NOT_ALLOWED);
+        }
+    }
+    catch(std::exception& e)
+    {
+        jsonResponse = {{"error", e.what()}};
+        response.setStatus(HTTPResponse::HTTP_BAD_REQUEST);
+    }
+
+    response.setContentType("text/json");
+    response.send() << jsonResponse.dump(4) << std::flush;
+}
+
+
+static const std::string INSTANCES_PATH = "/instances";
+
+static std::optional<std::size_t> ParseInstanceID(const std::string& path)
+{
+    // path is expected to be "/instances/{id}"
+    if(!path.starts_with(INSTANCES_PATH + '/'))
+        return std::nullopt;
+
+    return ParseID(std::string_view(path).substr(INSTANCES_PATH.size() + 1));
+}
+
+ScheduleInstancesRequestHandler::ScheduleInstancesRequestHandler(
+    std::shared_ptr<ScheduleInstances> instances,
+    std::shared_ptr<spdlog::logger> logger)
+    : instances_{std::move(instances)}
+    , logger_{std::move(logger)}
+{
+    assert(instances_ != nullptr);
+    assert(logger_ != nullptr);
+}
+
+static nlohmann::json DescribeInstance(std::size_t id, const ScheduleData& data)
+{
+    return {{"id", id},
+            {"subject_requests_count", data.SubjectRequests().size()},
+            {"blocks_count", data.Blocks().size()}};
+}
+
+void ScheduleInstancesRequestHandler::handleRequest(Poco::Net::HTTPServerRequest& request,
+                                                    Poco::Net::HTTPServerResponse& response)
+{
+    nlohmann::json jsonResponse;
+    try
+    {
+        const URI uri{request.getURI()};
+        const std::string& method = request.getMethod();
+        if(uri.getPath() == INSTANCES_PATH && method == HTTPRequest::HTTP_POST)
+        {
+            nlohmann::json jsonRequest;
+            const auto data = std::make_shared<const ScheduleData>(
+                RequireScheduleData(ReadRequestData(request, jsonRequest)));
+            const auto instanceID = instances_->Register(data);
+            if(instanceID)
+            {
+                logger_->info("Instance {} is registered: requests: {}",
+                              *instanceID,
+                              data->SubjectRequests().size());
+                jsonResponse = DescribeInstance(*instanceID, *data);
+                response.set("Location", INSTANCES_PATH + '/' + std::to_string(*instanceID));
+                response.setStatus(HTTPResponse::HTTP_CREATED);
+            }
+            else
+            {
+                logger_->warn("Instance is rejected: too many instances");
+                jsonResponse = {{"error", "Too many instances"}};
+                response.setStatus(HTTPResponse::HTTP_SERVICE_UNAVAILABLE);
+            }
+        }
+        else if(const auto id = ParseInstanceID(uri.getPath());
+                id && (method == HTTPRequest::HTTP_GET || method == HTTPRequest::HTTP_DELETE))
+        {
+            if(const auto data = instances_->Find(*id))
+            {
+                jsonResponse = DescribeInstance(*id, *data);
+                if(method == HTTPRequest::HTTP_DELETE)
+                {
+                    instances_->Remove(*id);
+                    logger_->info("Instance {} is removed", *id);
+                }
+
+                response.setStatus(HTTPResponse::HTTP_OK);
+            }
+            else
+            {
+                jsonResponse = {{"error", "Instance is not found"}};
+                response.setStatus(HTTPResponse::HTTP_NOT_FOUND);
+            }
+        }
+        else
+        {
+            jsonResponse = {{"error", "Unsupported instances request"}};
+            response.setStatus(HTTPResponse::HTTP_METHOD_NOT_ALLOWED);
+        }
     }
     catch(std::exception& e)
     {
@@ -69,11 +879,234 @@ void CheckScheduleRequestHandler::handleRequest(Poco::Net::HTTPServerRequest& re
 }
 
 
-ScheduleRequestHandlerFactory::ScheduleRequestHandlerFactory(ScheduleGA generator, std::shared_ptr<spdlog::logger> logger)
+static const std::string SESSIONS_PATH = "/sessions";
+static const std::string SESSION_REQUESTS_PATH = "/requests";
+
+struct SessionPath
+{
+    std::size_t SessionID = 0;
+    // path addresses the subject requests of the session
+    bool Requests = false;
+    std::optional<std::size_t> RequestID;
+};
+
+static std::optional<SessionPath> ParseSessionPath(const std::string& path)
+{
+    // path is expected to be "/sessions/{id}[/requests[/{requestID}]]"
+    if(!path.starts_with(SESSIONS_PATH + '/'))
+        return std::nullopt;
+
+    std::string_view rest = std::string_view(path).substr(SESSIONS_PATH.size() + 1);
+    const std::size_t idEnd = std::min(rest.find('/'), rest.size());
+    const auto sessionID = ParseID(rest.substr(0, idEnd));
+    if(!sessionID)
+        return std::nullopt;
+
+    SessionPath sessionPath{.SessionID = *sessionID};
+    rest.remove_prefix(idEnd);
+    if(rest.empty())
+        return sessionPath;
+
+    if(!rest.starts_with(SESSION_REQUESTS_PATH))
+        return std::nullopt;
+
+    sessionPath.Requests = true;
+    rest.remove_prefix(SESSION_REQUESTS_PATH.size());
+    if(rest.empty())
+        return sessionPath;
+
+    if(!rest.starts_with('/'))
+        return std::nullopt;
+
+    sessionPath.RequestID = ParseID(rest.substr(1));
+    if(!sessionPath.RequestID)
+        return std::nullopt;
+
+    return sessionPath;
+}
+
+// Edits of the subject requests re-optimize the schedule of the session
+static bool EditsSessionRequests(const std::optional<SessionPath>& sessionPath,
+                                 const std::string& method)
+{
+    if(!sessionPath || !sessionPath->Requests)
+        return false;
+
+    if(sessionPath->RequestID)
+        return method == HTTPRequest::HTTP_PUT || method == HTTPRequest::HTTP_DELETE;
+
+    return method == HTTPRequest::HTTP_POST;
+}
+
+ScheduleSessionsRequestHandler::ScheduleSessionsRequestHandler(
+    std::shared_ptr<ScheduleSessions> sessions,
+    std::shared_ptr<ScheduleAdmission> admission,
+    std::shared_ptr<spdlog::logger> logger)
+    : sessions_{std::move(sessions)}
+    , admission_{std::move(admission)}
+    , logger_{std::move(logger)}
+{
+    assert(sessions_ != nullptr);
+    assert(admission_ != nullptr);
+    assert(logger_ != nullptr);
+}
+
+void ScheduleSessionsRequestHandler::handleRequest(Poco::Net::HTTPServerRequest& request,
+                                                   Poco::Net::HTTPServerResponse& response)
+{
+    nlohmann::json jsonResponse;
+    try
+    {
+        const URI uri{request.getURI()};
+        const std::string& method = request.getMethod();
+        const auto sessionPath = ParseSessionPath(uri.getPath());
+        if(uri.getPath() == SESSIONS_PATH && method == HTTPRequest::HTTP_POST)
+        {
+            nlohmann::json jsonRequest;
+            auto data = RequireScheduleData(ReadRequestData(request, jsonRequest));
+
+            // the first solve of the session takes the slot like the other solves
+            const auto permit = admission_->Acquire();
+            std::optional<ScheduleSessionState> state;
+            if(permit)
+            {
+                logger_->info("Start generate schedule of the new session...");
+                state = sessions_->Create(std::move(data), ParsePriorSchedule(jsonRequest));
+            }
+
+            if(!permit)
+            {
+                logger_->warn("Session is rejected: too many solves");
+                jsonResponse = {{"error", OVERLOADED_ERROR}};
+                SetOverloadedStatus(response, *admission_);
+            }
+            else if(state)
+            {
+                logger_->info("Session {} is created", state->ID);
+                jsonResponse = *state;
+                response.set("Location", SESSIONS_PATH + '/' + std::to_string(state->ID));
+                response.setStatus(HTTPResponse::HTTP_CREATED);
+            }
+            else
+            {
+                logger_->warn("Session is rejected: too many sessions");
+                jsonResponse = {{"error", "Too many sessions"}};
+                response.setStatus(HTTPResponse::HTTP_SERVICE_UNAVAILABLE);
+            }
+        }
+        else if(!sessionPath)
+        {
+            jsonResponse = {{"error", "Unsupported sessions request"}};
+            response.setStatus(HTTPResponse::HTTP_METHOD_NOT_ALLOWED);
+        }
+        else if(const auto session = sessions_->Find(sessionPath->SessionID); !session)
+        {
+            jsonResponse = {{"error", "Session is not found"}};
+            response.setStatus(HTTPResponse::HTTP_NOT_FOUND);
+        }
+        else if(!sessionPath->Requests
+                && (method == HTTPRequest::HTTP_GET || method == HTTPRequest::HTTP_DELETE))
+        {
+            jsonResponse = session->State();
+            if(method == HTTPRequest::HTTP_DELETE)
+            {
+                sessions_->Remove(sessionPath->SessionID);
+                logger_->info("Session {} is closed", sessionPath->SessionID);
+            }
+
+            response.setStatus(HTTPResponse::HTTP_OK);
+        }
+        else if(EditsSessionRequests(sessionPath, method))
+        {
+            std::optional<SubjectRequest> subjectRequest;
+            if(method != HTTPRequest::HTTP_DELETE)
+            {
+                // the edit is encoded like the other bodies, it has no schedule data
+                nlohmann::json jsonRequest;
+                if(ReadRequestData(request, jsonRequest))
+                    throw std::invalid_argument("Subject request object expected");
+
+                subjectRequest = jsonRequest.get<SubjectRequest>();
+                if(sessionPath->RequestID && subjectRequest->ID() != *sessionPath->RequestID)
+                    throw std::invalid_argument("Subject request ID doesn't match the path");
+            }
+
+            // the re-optimization after the edit takes the slot like the other solves
+            const auto permit = admission_->Acquire();
+            if(!permit)
+            {
+                logger_->warn("Session {} edit is rejected: too many solves",
+                              sessionPath->SessionID);
+                jsonResponse = {{"error", OVERLOADED_ERROR}};
+                SetOverloadedStatus(response, *admission_);
+            }
+            else
+            {
+                ScheduleSessionState state;
+                if(method == HTTPRequest::HTTP_DELETE)
+                    state = session->RemoveRequest(*sessionPath->RequestID);
+                else if(method == HTTPRequest::HTTP_POST)
+                    state = session->AddRequest(std::move(*subjectRequest));
+                else
+                    state = session->ModifyRequest(std::move(*subjectRequest));
+
+                logger_->info("Session {} edit {}: affected requests: {}, iterations: {}",
+                              state.ID,
+                              state.Version,
+                              state.AffectedRequests.size(),
+                              state.Iterations);
+                jsonResponse = std::move(state);
+                response.setStatus(HTTPResponse::HTTP_OK);
+            }
+        }
+        else
+        {
+            jsonResponse = {{"error", "Unsupported sessions request"}};
+            response.setStatus(HTTPResponse::HTTP_METHOD_NOT_ALLOWED);
+        }
+    }
+    catch(std::out_of_range& e)
+    {
+        jsonResponse = {{"error", e.what()}};
+        response.setStatus(HTTPResponse::HTTP_NOT_FOUND);
+    }
+    catch(std::exception& e)
+    {
+        jsonResponse = {{"error", e.what()}};
+        response.setStatus(HTTPResponse::HTTP_BAD_REQUEST);
+    }
+
+    response.setContentType("text/json");
+    response.send() << jsonResponse.dump(4) << std::flush;
+}
+
+
+ScheduleRequestHandlerFactory::ScheduleRequestHandlerFactory(
+    ScheduleGA generator,
+    std::shared_ptr<ScheduleJobsManager> jobs,
+    std::shared_ptr<ScheduleSessions> sessions,
+    std::shared_ptr<ScheduleInstances> instances,
+    std::shared_ptr<ScheduleResultCache> resultCache,
+    std::shared_ptr<ScheduleAdmission> admission,
+    std::size_t compressionMinSize,
+    std::shared_ptr<spdlog::logger> logger)
     : logger_{std::move(logger)}
     , generator_{std::move(generator)}
+    , jobs_{std::move(jobs)}
+    , sessions_{std::move(sessions)}
+    , instances_{std::move(instances)}
+    , resultCache_{std::move(resultCache)}
+    , solveFlights_{std::make_shared<ScheduleSolveFlights>()}
+    , admission_{std::move(admission)}
+    , metrics_{std::make_shared<ScheduleMetrics>()}
+    , compressionMinSize_{compressionMinSize}
 {
     assert(logger_ != nullptr);
+    assert(jobs_ != nullptr);
+    assert(sessions_ != nullptr);
+    assert(instances_ != nullptr);
+    assert(resultCache_ != nullptr);
+    assert(admission_ != nullptr);
 }
 
 Poco::Net::HTTPRequestHandler*
@@ -83,10 +1116,52 @@ Poco::Net::HTTPRequestHandler*
         return nullptr;
 
     const URI uri{request.getURI()};
-    if(uri.getPath() == "/makeSchedule")
-        return new MakeScheduleRequestHandler(generator_, logger_);
-    else if(uri.getPath() == "/checkSchedule")
-        return new CheckScheduleRequestHandler;
-    else
+    const auto endpoint = FindScheduleEndpoint(uri.getPath());
+    if(!endpoint)
         return nullptr;
+
+    // New solves are rejected before their bodies are read. The cache key of /makeSchedule
+    // is known only after its body is parsed, so under the load even the requests
+    // which would hit the cache or join the running solve are rejected here.
+    const bool startsSolve =
+        endpoint == ScheduleEndpoint::MakeSchedule
+        || (uri.getPath() == SESSIONS_PATH && request.getMethod() == HTTPRequest::HTTP_POST)
+        || EditsSessionRequests(ParseSessionPath(uri.getPath()), request.getMethod());
+    std::unique_ptr<HTTPRequestHandler> handler(
+        startsSolve && admission_->TryReject() ? new ScheduleOverloadedRequestHandler(admission_)
+                                               : CreateEndpointHandler(*endpoint));
+    return new MeteredRequestHandler(std::move(handler), *endpoint, metrics_);
+}
+
+Poco::Net::HTTPRequestHandler*
+    ScheduleRequestHandlerFactory::CreateEndpointHandler(ScheduleEndpoint endpoint)
+{
+    switch(endpoint)
+    {
+    case ScheduleEndpoint::MakeSchedule:
+        return new MakeScheduleRequestHandler(generator_,
+                                              instances_,
+                                              resultCache_,
+                                              solveFlights_,
+                                              admission_,
+                                              metrics_,
+                                              compressionMinSize_,
+                                              logger_);
+    case ScheduleEndpoint::CheckSchedule:
+        return new CheckScheduleRequestHandler(instances_, compressionMinSize_);
+    case ScheduleEndpoint::Jobs:
+        return new ScheduleJobsRequestHandler(jobs_, instances_, logger_);
+    case ScheduleEndpoint::Instances:
+        return new ScheduleInstancesRequestHandler(instances_, logger_);
+    case ScheduleEndpoint::Sessions:
+        return new ScheduleSessionsRequestHandler(sessions_, admission_, logger_);
+    case ScheduleEndpoint::CacheStats:
+        return new CacheStatsRequestHandler(resultCache_);
+    case ScheduleEndpoint::AdmissionStats:
+        return new AdmissionStatsRequestHandler(admission_);
+    case ScheduleEndpoint::Metrics:
+        return new MetricsRequestHandler(metrics_, admission_, resultCache_);
+    }
+
+    return nullptr;
 }
@@ -3,13 +3,23 @@
 #include "ScheduleDataSerialization.h"
 
 #include <Poco/Net/HTTPServer.h>
+#include <Poco/ThreadPool.h>
+#include <Poco/Timespan.h>
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
+#include <chrono>
 #include <fstream>
 
 
 static const std::string OPTIONS_FILENAME = "options.json";
-static constexpr std::uint16_t SERVER_DEFAULT_PORT = 9304;
+// every solve already uses all threads of the solver pool, so jobs are solved one by one
+static constexpr std::size_t JOBS_WORKERS_COUNT = 1;
+static constexpr std::size_t JOBS_MAX_QUEUED = 16;
+static constexpr std::size_t JOBS_MAX_FINISHED = 64;
+static constexpr std::size_t SESSIONS_MAX_COUNT = 16;
+static constexpr std::size_t INSTANCES_MAX_COUNT = 32;
+// every edit of the session is re-optimized within this budget
+static constexpr std::chrono::milliseconds SESSION_EDIT_TIME_LIMIT{500};
 
 
 ScheduleServer::ScheduleServer(std::shared_ptr<spdlog::logger> logger)
@@ -20,7 +30,8 @@ ScheduleServer::ScheduleServer(std::shared_ptr<spdlog::logger> logger)
 
     try
     {
-        generator_.SetParams(LoadOptions(OPTIONS_FILENAME, *logger_));
+        options_ = LoadOptions(OPTIONS_FILENAME, *logger_);
+        generator_.SetParams(options_.GAParams);
     }
     catch(std::exception& e)
     {
@@ -28,13 +39,50 @@ ScheduleServer::ScheduleServer(std::shared_ptr<spdlog::logger> logger)
     }
 }
 
+static Poco::Net::HTTPServerParams::Ptr MakeHTTPServerParams(const ScheduleServerOptions& options)
+{
+    using Poco::Timespan;
+
+    Poco::Net::HTTPServerParams::Ptr params = new Poco::Net::HTTPServerParams;
+    params->setMaxThreads(options.HttpMaxThreads);
+    params->setMaxQueued(options.HttpMaxQueued);
+    params->setKeepAlive(options.HttpKeepAlive);
+    params->setMaxKeepAliveRequests(options.HttpMaxKeepAliveRequests);
+    params->setKeepAliveTimeout(Timespan(options.HttpKeepAliveTimeout * Timespan::MILLISECONDS));
+    params->setTimeout(Timespan(options.HttpTimeout * Timespan::MILLISECONDS));
+    return params;
+}
+
 int ScheduleServer::main(const std::vector<std::string>&)
 {
     using namespace Poco::Net;
 
-    HTTPServer s(new ScheduleRequestHandlerFactory(generator_, logger_),
-                 ServerSocket(SERVER_DEFAULT_PORT),
-                 new HTTPServerParams);
+    // the GA of all the solves runs on the solver pool instead of the HTTP threads
+    auto workerPool = std::make_shared<ScheduleWorkerPool>(options_.SolverThreads);
+    generator_.SetWorkerPool(workerPool);
+    logger_->info("Solver pool threads: {}", workerPool->ThreadsCount());
+
+    auto jobs = std::make_shared<ScheduleJobsManager>(
+        generator_, JOBS_WORKERS_COUNT, JOBS_MAX_QUEUED, JOBS_MAX_FINISHED);
+    auto sessions = std::make_shared<ScheduleSessions>(
+        generator_, SESSION_EDIT_TIME_LIMIT, SESSIONS_MAX_COUNT);
+    auto instances = std::make_shared<ScheduleInstances>(INSTANCES_MAX_COUNT);
+    auto resultCache = std::make_shared<ScheduleResultCache>(options_.ResultCacheCapacity);
+    auto admission =
+        std::make_shared<ScheduleAdmission>(options_.MaxActiveSolves, options_.MaxQueuedSolves);
+    // the default thread pool of Poco is limited to 16 threads
+    Poco::ThreadPool httpThreads(std::min(2, options_.HttpMaxThreads), options_.HttpMaxThreads);
+    HTTPServer s(new ScheduleRequestHandlerFactory(generator_,
+                                                   jobs,
+                                                   sessions,
+                                                   instances,
+                                                   resultCache,
+                                                   admission,
+                                                   options_.CompressionMinSize,
+                                                   logger_),
+                 httpThreads,
+                 ServerSocket(options_.Port),
+                 MakeHTTPServerParams(options_));
     s.start();
 
     int ch = 0;
@@ -45,6 +93,57 @@ int ScheduleServer::main(const std::vector<std::string>&)
 }
 
 
+void from_json(const nlohmann::json& j, ScheduleServerOptions& options)
+{
+    j.get_to(options.GAParams);
+
+    const ScheduleServerOptions defaultOptions;
+    options.ResultCacheCapacity =
+        j.value("result_cache_capacity", defaultOptions.ResultCacheCapacity);
+    options.CompressionMinSize =
+        j.value("compression_min_size", defaultOptions.CompressionMinSize);
+    options.MaxActiveSolves = j.value("max_active_solves", defaultOptions.MaxActiveSolves);
+    options.MaxQueuedSolves = j.value("max_queued_solves", defaultOptions.MaxQueuedSolves);
+    options.SolverThreads = j.value("solver_threads", defaultOptions.SolverThreads);
+
+    options.Port = j.value("port", defaultOptions.Port);
+    options.HttpMaxThreads = j.value("http_max_threads", defaultOptions.HttpMaxThreads);
+    options.HttpMaxQueued = j.value("http_max_queued", defaultOptions.HttpMaxQueued);
+    options.HttpKeepAlive = j.value("http_keep_alive", defaultOptions.HttpKeepAlive);
+    options.HttpMaxKeepAliveRequests =
+        j.value("http_max_keep_alive_requests", defaultOptions.HttpMaxKeepAliveRequests);
+    options.HttpKeepAliveTimeout =
+        j.value("http_keep_alive_timeout", defaultOptions.HttpKeepAliveTimeout);
+    options.HttpTimeout = j.value("http_timeout", defaultOptions.HttpTimeout);
+
+    if(options.HttpMaxThreads < 1)
+        throw std::invalid_argument("Invalid http_max_threads option: must be greater than zero");
+
+    if(options.HttpMaxQueued < 0 || options.HttpMaxKeepAliveRequests < 0
+       || options.HttpKeepAliveTimeout < 0 || options.HttpTimeout < 0)
+        throw std::invalid_argument(
+            "Invalid HTTP options: queue length, keep-alive requests and timeouts must be "
+            "greater or equal to zero");
+}
+
+void to_json(nlohmann::json& j, const ScheduleServerOptions& options)
+{
+    j = options.GAParams;
+    j["result_cache_capacity"] = options.ResultCacheCapacity;
+    j["compression_min_size"] = options.CompressionMinSize;
+    j["max_active_solves"] = options.MaxActiveSolves;
+    j["max_queued_solves"] = options.MaxQueuedSolves;
+    j["solver_threads"] = options.SolverThreads;
+
+    j["port"] = options.Port;
+    j["http_max_threads"] = options.HttpMaxThreads;
+    j["http_max_queued"] = options.HttpMaxQueued;
+    j["http_keep_alive"] = options.HttpKeepAlive;
+    j["http_max_keep_alive_requests"] = options.HttpMaxKeepAliveRequests;
+    j["http_keep_alive_timeout"] = options.HttpKeepAliveTimeout;
+    j["http_timeout"] = options.HttpTimeout;
+}
+
 void CreateDefaultOptionsFile(const std::string& filename, spdlog::logger& logger)
 {
     logger.info("Creating '{}' file with default options", filename);
@@ -52,18 +151,18 @@ void CreateDefaultOptionsFile(const std::string& filename, spdlog::logger& logge
     if(!optionsFile)
         throw std::runtime_error("Unable to create '" + filename + "' file");
 
-    nlohmann::json j = ScheduleGA::DefaultParams();
+    nlohmann::json j = ScheduleServerOptions{};
     optionsFile << j.dump(4);
 }
 
-ScheduleGAParams LoadOptions(const std::string& filename, spdlog::logger& logger)
+ScheduleServerOptions LoadOptions(const std::string& filename, spdlog::logger& logger)
 {
     std::fstream optionsFile(filename, std::ios::in);
     if(!optionsFile)
     {
         logger.warn("'{}' file is not found!", filename);
         CreateDefaultOptionsFile(filename, logger);
-        return ScheduleGA::DefaultParams();
+        return ScheduleServerOptions{};
     }
 
     nlohmann::json jsonOptions;
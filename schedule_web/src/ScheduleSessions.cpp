@@ -0,0 +1,252 @@
+#include "ScheduleSessions.h"
+
+#include "ScheduleChromosomes.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+
+static std::vector<std::vector<std::size_t>> BlocksIDs(const ScheduleData& data)
+{
+    std::vector<std::vector<std::size_t>> blocksIDs;
+    blocksIDs.reserve(data.Blocks().size());
+    for(auto&& block : data.Blocks())
+    {
+        auto& blockIDs = blocksIDs.emplace_back();
+        for(std::size_t r : block.Requests())
+            blockIDs.emplace_back(data.SubjectRequests().at(r).ID());
+    }
+
+    return blocksIDs;
+}
+
+static std::vector<SubjectRequest>::iterator FindRequest(std::vector<SubjectRequest>& requests,
+                                                         std::size_t requestID)
+{
+    const auto it = std::ranges::lower_bound(requests, requestID, {}, &SubjectRequest::ID);
+    return it != requests.end() && it->ID() == requestID ? it : requests.end();
+}
+
+// IDs of the requests intersecting the given ones in the data, missing requests are skipped
+static std::vector<std::size_t> IntersectingRequestsIDs(const ScheduleData& data,
+                                                        const std::vector<std::size_t>& requestsIDs)
+{
+    const auto& requests = data.SubjectRequests();
+    std::vector<std::size_t> requestsIndexes;
+    for(std::size_t id : requestsIDs)
+    {
+        const auto it = std::ranges::lower_bound(requests, id, {}, &SubjectRequest::ID);
+        if(it != requests.end() && it->ID() == id)
+            requestsIndexes.emplace_back(std::distance(requests.begin(), it));
+    }
+
+    std::vector<std::size_t> intersectingIDs;
+    for(std::size_t r : FindIntersectingRequests(data, requestsIndexes))
+        intersectingIDs.emplace_back(requests.at(r).ID());
+
+    return intersectingIDs;
+}
+
+static ScheduleResult WithoutRequests(const ScheduleResult& schedule,
+                                      const std::vector<std::size_t>& sortedIDs)
+{
+    std::vector<ScheduleItem> items;
+    items.reserve(schedule.items().size());
+    std::ranges::copy_if(schedule,
+                         std::back_inserter(items),
+                         [&](const ScheduleItem& item)
+                         { return !std::ranges::binary_search(sortedIDs, item.SubjectRequestID); });
+
+    return ScheduleResult(std::move(items));
+}
+
+
+ScheduleSession::ScheduleSession(std::size_t id,
+                                 ScheduleGA generator,
+                                 ScheduleData data,
+                                 ScheduleResult schedule,
+                                 std::size_t evaluation,
+                                 std::size_t iterations)
+    : id_(id)
+    , generator_(std::move(generator))
+    , data_(std::move(data))
+    , blocksIDs_(BlocksIDs(data_))
+    , schedule_(std::move(schedule))
+    , evaluation_(evaluation)
+    , iterations_(iterations)
+{
+}
+
+ScheduleSessionState ScheduleSession::State() const
+{
+    std::lock_guard lock(mutex_);
+    return MakeState();
+}
+
+ScheduleSessionState ScheduleSession::AddRequest(SubjectRequest request)
+{
+    std::lock_guard lock(mutex_);
+    const std::size_t id = request.ID();
+    auto requests = data_.SubjectRequests();
+    if(FindRequest(requests, id) != requests.end())
+        throw std::invalid_argument("Subject request with ID=" + std::to_string(id)
+                                    + " already exists");
+
+    requests.insert(std::ranges::upper_bound(requests, id, {}, &SubjectRequest::ID),
+                    std::move(request));
+    return Apply(std::move(requests), blocksIDs_, {id}, {});
+}
+
+ScheduleSessionState ScheduleSession::ModifyRequest(SubjectRequest request)
+{
+    std::lock_guard lock(mutex_);
+    const std::size_t id = request.ID();
+    auto requests = data_.SubjectRequests();
+    const auto it = FindRequest(requests, id);
+    if(it == requests.end())
+        throw std::out_of_range("Subject request with ID=" + std::to_string(id) + " is not found!");
+
+    *it = std::move(request);
+    return Apply(std::move(requests), blocksIDs_, {id}, {});
+}
+
+ScheduleSessionState ScheduleSession::RemoveRequest(std::size_t requestID)
+{
+    std::lock_guard lock(mutex_);
+    auto requests = data_.SubjectRequests();
+    const auto it = FindRequest(requests, requestID);
+    if(it == requests.end())
+        throw std::out_of_range("Subject request with ID=" + std::to_string(requestID)
+                                + " is not found!");
+
+    if(requests.size() == 1)
+        throw std::invalid_argument("The last subject request of the session can't be removed");
+
+    requests.erase(it);
+    // the rest of the block is not bound anymore
+    auto blocksIDs = blocksIDs_;
+    std::erase_if(blocksIDs,
+                  [&](const std::vector<std::size_t>& block)
+                  { return std::ranges::find(block, requestID) != block.end(); });
+
+    return Apply(std::move(requests), std::move(blocksIDs), {}, {requestID});
+}
+
+ScheduleSessionState ScheduleSession::Apply(std::vector<SubjectRequest> requests,
+                                            std::vector<std::vector<std::size_t>> blocksIDs,
+                                            const std::vector<std::size_t>& changedIDs,
+                                            const std::vector<std::size_t>& removedIDs)
+{
+    // intersections of the requests untouched by the edit are kept
+    auto intersections = UpdateIntersectionsMatrix(requests, data_, changedIDs);
+    auto blocks = ToSubjectsBlocks(requests, blocksIDs);
+    ScheduleData data(std::move(requests), std::move(blocks), std::move(intersections));
+
+    // neighbours of the changed requests after the edit and of the changed or removed ones before
+    std::vector<std::size_t> editedIDs = changedIDs;
+    editedIDs.insert(editedIDs.end(), removedIDs.begin(), removedIDs.end());
+    std::vector<std::size_t> affectedIDs = IntersectingRequestsIDs(data, changedIDs);
+    std::ranges::copy(IntersectingRequestsIDs(data_, editedIDs), std::back_inserter(affectedIDs));
+    std::ranges::sort(affectedIDs);
+    affectedIDs.erase(std::unique(affectedIDs.begin(), affectedIDs.end()), affectedIDs.end());
+    std::erase_if(affectedIDs,
+                  [&](std::size_t id) { return std::ranges::binary_search(removedIDs, id); });
+
+    // the changed requests are placed again first, their neighbours move only if they have to
+    ScheduleChromosomes chromosomes =
+        InitializeChromosomes(data, WithoutRequests(schedule_, changedIDs));
+    if(chromosomes.UnassignedLessonsCount() > 0)
+        chromosomes = InitializeChromosomes(data, WithoutRequests(schedule_, affectedIDs));
+
+    ScheduleGAProgress progress;
+    ScheduleResult schedule =
+        Generate(generator_, data, MakeScheduleResult(chromosomes, data), progress);
+
+    data_ = std::move(data);
+    blocksIDs_ = std::move(blocksIDs);
+    schedule_ = std::move(schedule);
+    ++version_;
+    evaluation_ = progress.BestEvaluation();
+    iterations_ = progress.Iteration();
+    affectedRequests_ = std::move(affectedIDs);
+    return MakeState();
+}
+
+ScheduleSessionState ScheduleSession::MakeState() const
+{
+    return ScheduleSessionState{.ID = id_,
+                                .Version = version_,
+                                .Schedule = schedule_,
+                                .Evaluation = evaluation_,
+                                .Iterations = iterations_,
+                                .AffectedRequests = affectedRequests_};
+}
+
+
+ScheduleSessions::ScheduleSessions(ScheduleGA generator,
+                                   std::chrono::milliseconds editTimeLimit,
+                                   std::size_t maxSessionsCount)
+    : generator_(std::move(generator))
+    , editGenerator_(generator_)
+    , maxSessionsCount_(maxSessionsCount)
+{
+    if(editTimeLimit.count() <= 0)
+        throw std::invalid_argument("Invalid edit time limit: must be greater than zero");
+
+    if(maxSessionsCount_ < 1)
+        throw std::invalid_argument("Invalid max sessions count: must be greater than zero");
+
+    ScheduleGAParams editParams = generator_.Params();
+    editParams.TimeLimit = static_cast<int>(editTimeLimit.count());
+    editGenerator_.SetParams(editParams);
+}
+
+std::optional<ScheduleSessionState> ScheduleSessions::Create(ScheduleData data,
+                                                             std::optional<ScheduleResult> prior)
+{
+    if(Count() >= maxSessionsCount_)
+        return std::nullopt;
+
+    ScheduleGAProgress progress;
+    ScheduleResult schedule =
+        prior ? Generate(generator_, data, *prior, progress) : Generate(generator_, data, progress);
+
+    std::shared_ptr<ScheduleSession> session;
+    {
+        std::lock_guard lock(mutex_);
+        // other sessions could be created during the solve
+        if(sessions_.size() >= maxSessionsCount_)
+            return std::nullopt;
+
+        session = std::make_shared<ScheduleSession>(++lastID_,
+                                                    editGenerator_,
+                                                    std::move(data),
+                                                    std::move(schedule),
+                                                    progress.BestEvaluation(),
+                                                    progress.Iteration());
+        sessions_.emplace(lastID_, session);
+    }
+
+    return session->State();
+}
+
+std::shared_ptr<ScheduleSession> ScheduleSessions::Find(std::size_t id) const
+{
+    std::lock_guard lock(mutex_);
+    const auto it = sessions_.find(id);
+    return it != sessions_.end() ? it->second : nullptr;
+}
+
+bool ScheduleSessions::Remove(std::size_t id)
+{
+    std::lock_guard lock(mutex_);
+    return sessions_.erase(id) != 0;
+}
+
+std::size_t ScheduleSessions::Count() const
+{
+    std::lock_guard lock(mutex_);
+    return sessions_.size();
+}
@@ -0,0 +1,88 @@
+#include "ScheduleSolveFlights.h"
+
+#include <cassert>
+
+
+bool ScheduleSolveFlight::Join()
+{
+    std::lock_guard lock(mutex_);
+    if(stopSource_.stop_requested())
+        return false;
+
+    ++participantsCount_;
+    return true;
+}
+
+void ScheduleSolveFlight::Leave()
+{
+    std::lock_guard lock(mutex_);
+    assert(participantsCount_ > 0);
+    if(--participantsCount_ == 0 && !outcome_)
+        stopSource_.request_stop();
+}
+
+void ScheduleSolveFlight::Complete(ScheduleSolveOutcome outcome)
+{
+    {
+        std::lock_guard lock(mutex_);
+        outcome_ = std::move(outcome);
+    }
+
+    completed_.notify_all();
+}
+
+bool ScheduleSolveFlight::Completed() const
+{
+    std::lock_guard lock(mutex_);
+    return outcome_.has_value();
+}
+
+bool ScheduleSolveFlight::Wait(std::stop_token stopToken) const
+{
+    std::unique_lock lock(mutex_);
+    return completed_.wait(lock, stopToken, [&] { return outcome_.has_value(); });
+}
+
+bool ScheduleSolveFlight::WaitFor(std::chrono::milliseconds timeout) const
+{
+    std::unique_lock lock(mutex_);
+    return completed_.wait_for(lock, timeout, [&] { return outcome_.has_value(); });
+}
+
+const ScheduleSolveOutcome& ScheduleSolveFlight::Outcome() const
+{
+    std::lock_guard lock(mutex_);
+    assert(outcome_);
+    // the outcome is not changed after completion
+    return *outcome_;
+}
+
+
+std::pair<std::shared_ptr<ScheduleSolveFlight>, bool>
+    ScheduleSolveFlights::Join(const ScheduleCacheKey& key)
+{
+    std::lock_guard lock(mutex_);
+    auto& flight = flights_[key];
+    // the stopped flight is abandoned by all its participants, its result is useless
+    if(flight != nullptr && flight->Join())
+        return {flight, false};
+
+    flight = std::make_shared<ScheduleSolveFlight>();
+    return {flight, true};
+}
+
+void ScheduleSolveFlights::Finish(const ScheduleCacheKey& key,
+                                  const std::shared_ptr<ScheduleSolveFlight>& flight)
+{
+    std::lock_guard lock(mutex_);
+    // the abandoned flight can be replaced by the new one already
+    const auto it = flights_.find(key);
+    if(it != flights_.end() && it->second == flight)
+        flights_.erase(it);
+}
+
+std::size_t ScheduleSolveFlights::Count() const
+{
+    std::lock_guard lock(mutex_);
+    return flights_.size();
+}
@@ -0,0 +1,235 @@
+#include "ScheduleWireFormat.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <optional>
+#include <ostream>
+#include <utility>
+
+
+constexpr std::array MEDIA_TYPES = {
+    std::pair{std::string_view{"application/json"}, ScheduleWireFormat::Json},
+    std::pair{std::string_view{"text/json"}, ScheduleWireFormat::Json},
+    std::pair{std::string_view{"application/cbor"}, ScheduleWireFormat::Cbor},
+    std::pair{std::string_view{"application/msgpack"}, ScheduleWireFormat::MessagePack},
+    std::pair{std::string_view{"application/x-msgpack"}, ScheduleWireFormat::MessagePack},
+    std::pair{std::string_view{"application/vnd.msgpack"}, ScheduleWireFormat::MessagePack}};
+
+constexpr std::array CONTENT_ENCODINGS = {
+    std::pair{std::string_view{"identity"}, ScheduleContentEncoding::Identity},
+    std::pair{std::string_view{"gzip"}, ScheduleContentEncoding::Gzip},
+    std::pair{std::string_view{"x-gzip"}, ScheduleContentEncoding::Gzip},
+    std::pair{std::string_view{"deflate"}, ScheduleContentEncoding::Deflate}};
+
+static std::string_view Trim(std::string_view str)
+{
+    const auto first = str.find_first_not_of(" \t");
+    if(first == std::string_view::npos)
+        return {};
+
+    return str.substr(first, str.find_last_not_of(" \t") - first + 1);
+}
+
+static std::optional<ScheduleWireFormat> FindMediaType(std::string_view mediaType)
+{
+    // parameters like charset or q are not used
+    mediaType = Trim(mediaType.substr(0, mediaType.find(';')));
+    for(auto&& [name, format] : MEDIA_TYPES)
+    {
+        if(mediaType == name)
+            return format;
+    }
+
+    return std::nullopt;
+}
+
+ScheduleWireFormat RequestWireFormat(std::string_view contentType)
+{
+    return FindMediaType(contentType).value_or(ScheduleWireFormat::Json);
+}
+
+ScheduleWireFormat ResponseWireFormat(std::string_view accept)
+{
+    while(!accept.empty())
+    {
+        const std::size_t end = std::min(accept.find(','), accept.size());
+        if(const auto format = FindMediaType(accept.substr(0, end)))
+            return *format;
+
+        accept.remove_prefix(std::min(end + 1, accept.size()));
+    }
+
+    return ScheduleWireFormat::Json;
+}
+
+std::string_view ContentType(ScheduleWireFormat format)
+{
+    switch(format)
+    {
+    case ScheduleWireFormat::Cbor:
+        return "application/cbor";
+    case ScheduleWireFormat::MessagePack:
+        return "application/msgpack";
+    default:
+        return "text/json";
+    }
+}
+
+nlohmann::json::input_format_t InputFormat(ScheduleWireFormat format)
+{
+    switch(format)
+    {
+    case ScheduleWireFormat::Cbor:
+        return nlohmann::json::input_format_t::cbor;
+    case ScheduleWireFormat::MessagePack:
+        return nlohmann::json::input_format_t::msgpack;
+    default:
+        return nlohmann::json::input_format_t::json;
+    }
+}
+
+void WriteBody(std::ostream& os,
+               const nlohmann::json& body,
+               ScheduleWireFormat format,
+               int indent)
+{
+    switch(format)
+    {
+    case ScheduleWireFormat::Cbor:
+        nlohmann::json::to_cbor(body, os);
+        break;
+    case ScheduleWireFormat::MessagePack:
+        nlohmann::json::to_msgpack(body, os);
+        break;
+    default:
+        os << body.dump(indent);
+        break;
+    }
+
+    os << std::flush;
+}
+
+static std::optional<ScheduleContentEncoding> FindContentEncoding(std::string_view coding)
+{
+    coding = Trim(coding);
+    for(auto&& [name, encoding] : CONTENT_ENCODINGS)
+    {
+        if(coding == name)
+            return encoding;
+    }
+
+    return std::nullopt;
+}
+
+// Whether the coding parameters have zero quality value
+static bool Refused(std::string_view parameters)
+{
+    const auto q = parameters.find("q=");
+    if(q == std::string_view::npos)
+        return false;
+
+    double quality = 1.0;
+    const auto value = parameters.substr(q + 2);
+    std::from_chars(value.data(), value.data() + value.size(), quality);
+    return quality <= 0.0;
+}
+
+std::optional<ScheduleContentEncoding> RequestContentEncoding(std::string_view contentEncoding)
+{
+    if(Trim(contentEncoding).empty())
+        return ScheduleContentEncoding::Identity;
+
+    return FindContentEncoding(contentEncoding);
+}
+
+ScheduleContentEncoding ResponseContentEncoding(std::string_view acceptEncoding)
+{
+    while(!acceptEncoding.empty())
+    {
+        const std::size_t end = std::min(acceptEncoding.find(','), acceptEncoding.size());
+        const std::string_view coding = acceptEncoding.substr(0, end);
+        const std::size_t parameters = std::min(coding.find(';'), coding.size());
+        const auto encoding = FindContentEncoding(coding.substr(0, parameters));
+        if(encoding && !Refused(coding.substr(parameters)))
+            return *encoding;
+
+        acceptEncoding.remove_prefix(std::min(end + 1, acceptEncoding.size()));
+    }
+
+    return ScheduleContentEncoding::Identity;
+}
+
+std::string_view ContentEncodingName(ScheduleContentEncoding encoding)
+{
+    switch(encoding)
+    {
+    case ScheduleContentEncoding::Gzip:
+        return "gzip";
+    case ScheduleContentEncoding::Deflate:
+        return "deflate";
+    default:
+        return "identity";
+    }
+}
+
+
+ScheduleBodyBuffer::ScheduleBodyBuffer(std::size_t compressionMinSize, OpenStream openStream)
+    : compressionMinSize_(compressionMinSize)
+    , openStream_(std::move(openStream))
+{
+    setp(chunk_.data(), chunk_.data() + chunk_.size());
+}
+
+void ScheduleBodyBuffer::Finish()
+{
+    FlushChunk();
+    if(stream_ == nullptr)
+        Open(head_.size());
+
+    stream_->flush();
+}
+
+ScheduleBodyBuffer::int_type ScheduleBodyBuffer::overflow(int_type ch)
+{
+    FlushChunk();
+    if(!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+
+    return traits_type::not_eof(ch);
+}
+
+int ScheduleBodyBuffer::sync()
+{
+    FlushChunk();
+    if(stream_ != nullptr)
+        stream_->flush();
+
+    return 0;
+}
+
+void ScheduleBodyBuffer::FlushChunk()
+{
+    const auto size = static_cast<std::size_t>(pptr() - pbase());
+    setp(chunk_.data(), chunk_.data() + chunk_.size());
+    if(stream_ != nullptr)
+    {
+        stream_->write(chunk_.data(), static_cast<std::streamsize>(size));
+        return;
+    }
+
+    head_.append(chunk_.data(), size);
+    if(head_.size() >= compressionMinSize_ && !head_.empty())
+        Open(std::nullopt);
+}
+
+void ScheduleBodyBuffer::Open(std::optional<std::size_t> bodySize)
+{
+    stream_ = &openStream_(bodySize);
+    stream_->write(head_.data(), static_cast<std::streamsize>(head_.size()));
+    head_.clear();
+    head_.shrink_to_fit();
+}
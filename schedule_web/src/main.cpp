@@ -1,17 +1,10 @@
-#include "ScheduleDataGenerator.h"
-#include "ScheduleDataSerialization.h"
 #include "ScheduleServer.h"
 
-#include <nlohmann/json.hpp>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/spdlog.h>
 
-#include <iostream>
-#include <random>
-
 
 std::shared_ptr<spdlog::logger> make_server_logger();
-void test_schedule_data_generator();
 
 int main(int argc, char** argv)
 {
@@ -29,24 +22,3 @@ std::shared_ptr<spdlog::logger> make_server_logger()
     spdlog::flush_every(std::chrono::seconds{3});
     return logger;
 }
-
-void test_schedule_data_generator()
-{
-    std::random_device randomDevice;
-    ScheduleDataGenerator generator{randomDevice,
-                                    ScheduleDataGeneratorParameters{.MinGroupsCount = 2,
-                                                                    .MaxGroupsCount = 10,
-                                                                    .MinLessonsCount = 1,
-                                                                    .MaxLessonsCount = 84,
-                                                                    .MinClassroomsCount = 1,
-                                                                    .MaxClassroomsCount = 7,
-                                                                    .MaxBuildingID = 3}};
-
-    nlohmann::json jData = generator.GenerateData(200, 20);
-
-    std::cout << jData.dump(4) << std::endl;
-
-    std::cout << "\n\nBlocks:\n";
-    std::cout << (jData.contains("blocks") ? jData["blocks"].dump(4) : "blocks are empty")
-              << std::endl;
-}
@@ -1,8 +1,23 @@
+#include "ScheduleAdmission.h"
+#include "ScheduleCache.h"
 #include "ScheduleGA.h"
 #include "ScheduleDataSerialization.h"
+#include "ScheduleInstances.h"
+#include "ScheduleJsonWriter.h"
+#include "ScheduleJobs.h"
+#include "ScheduleMetrics.h"
+#include "ScheduleProgressStream.h"
+#include "ScheduleSessions.h"
+#include "ScheduleSolveFlights.h"
+#include "ScheduleWireFormat.h"
 
 #include <catch2/catch.hpp>
 
+#include <chrono>
+#include <limits>
+#include <sstream>
+#include <thread>
+
 
 TEST_CASE("Parsing lessons set", "[parsing]")
 {
@@ -160,6 +175,321 @@ TEST_CASE("Parsing schedule item", "[parsing]")
     REQUIRE(scheduleItem == ScheduleItem{.Address = 7, .SubjectRequestID = 1, .Classroom = 4});
 }
 
+TEST_CASE("Prior schedule of the warm start is optional", "[parsing]")
+{
+    auto jsonRequest = R"(
+        {
+            "subject_requests": [
+                {"id": 1, "complexity": 1, "professor": 1, "groups": [1],
+                 "lessons": [0, 1], "classrooms": [[1]]}
+            ]
+        }
+    )"_json;
+    REQUIRE_FALSE(ParsePriorSchedule(jsonRequest).has_value());
+
+    jsonRequest["placed_lessons"] =
+        R"([{"address": 1, "subject_request_id": 1, "classroom": 1}])"_json;
+    const auto prior = ParsePriorSchedule(jsonRequest);
+    REQUIRE(prior.has_value());
+    REQUIRE(prior->items()
+            == std::vector<ScheduleItem>{
+                ScheduleItem{.Address = 1, .SubjectRequestID = 1, .Classroom = 1}});
+}
+
+TEST_CASE("Content codings are negotiated by the headers", "[wire_format]")
+{
+    REQUIRE(RequestContentEncoding("") == ScheduleContentEncoding::Identity);
+    REQUIRE(RequestContentEncoding(" gzip") == ScheduleContentEncoding::Gzip);
+    REQUIRE(RequestContentEncoding("deflate") == ScheduleContentEncoding::Deflate);
+    REQUIRE_FALSE(RequestContentEncoding("br").has_value());
+
+    REQUIRE(ResponseContentEncoding("") == ScheduleContentEncoding::Identity);
+    REQUIRE(ResponseContentEncoding("br, gzip;q=0.8") == ScheduleContentEncoding::Gzip);
+    REQUIRE(ResponseContentEncoding("gzip;q=0, deflate") == ScheduleContentEncoding::Deflate);
+    REQUIRE(ResponseContentEncoding("gzip; q=0.0") == ScheduleContentEncoding::Identity);
+}
+
+TEST_CASE("Body buffer compresses only the long bodies", "[wire_format]")
+{
+    const std::size_t bodySize = GENERATE(0, 10, 99, 100, 5000, 20000);
+    const std::string body(bodySize, 'x');
+
+    std::ostringstream out;
+    std::vector<std::optional<std::size_t>> openedSizes;
+    ScheduleBodyBuffer buffer(100,
+                              [&](std::optional<std::size_t> size) -> std::ostream&
+                              {
+                                  openedSizes.emplace_back(size);
+                                  return out;
+                              });
+    std::ostream os(&buffer);
+    for(char ch : body)
+        os << ch;
+
+    os << std::flush;
+    buffer.Finish();
+
+    REQUIRE(out.str() == body);
+    REQUIRE(openedSizes.size() == 1);
+    if(bodySize < 100)
+        REQUIRE(openedSizes.front() == bodySize);
+    else
+        REQUIRE_FALSE(openedSizes.front().has_value());
+}
+
+TEST_CASE("Streaming parser gives the same schedule data", "[parsing]")
+{
+    const auto jsonRequest = R"(
+        {
+            "instance_name": {"week": [1, 2], "draft": true},
+            "subject_requests": [
+                {"id": 3, "complexity": 2, "professor": 1, "groups": [2, 1, 2],
+                 "lessons": [5, 0, 5], "classrooms": [[1, 2], [2, 1]], "comment": [{}]},
+                {"id": 1, "complexity": 1.0, "professor": 2, "groups": [1],
+                 "lessons": [1, 2], "classrooms": [[], [3]]},
+                {"id": 2, "complexity": 1, "professor": 3, "groups": [3],
+                 "lessons": [1, 2], "classrooms": [[1]]},
+                {"id": 1, "complexity": 1, "professor": 2, "groups": [1],
+                 "lessons": [1, 2], "classrooms": [[], [3]]}
+            ],
+            "blocks": [[1, 2], [3]],
+            "placed_lessons": [{"address": 1, "subject_request_id": 2, "classroom": 1}]
+        }
+    )"_json;
+    const auto expected = jsonRequest.get<ScheduleData>();
+
+    const auto format = GENERATE(
+        ScheduleWireFormat::Json, ScheduleWireFormat::Cbor, ScheduleWireFormat::MessagePack);
+    std::stringstream body;
+    WriteBody(body, jsonRequest, format);
+
+    nlohmann::json rest;
+    const auto data = ReadScheduleData(body, InputFormat(format), rest);
+    REQUIRE(data.has_value());
+    REQUIRE(data->SubjectRequests() == expected.SubjectRequests());
+    REQUIRE(data->Blocks().size() == expected.Blocks().size());
+    REQUIRE(data->Blocks().front().Requests() == expected.Blocks().front().Requests());
+    REQUIRE(data->Blocks().front().Addresses() == expected.Blocks().front().Addresses());
+
+    REQUIRE(rest.size() == 2);
+    REQUIRE(rest.at("instance_name") == jsonRequest.at("instance_name"));
+    REQUIRE(ParsePriorSchedule(rest)->items() == ParsePriorSchedule(jsonRequest)->items());
+}
+
+TEST_CASE("Streaming parser checks the values like the DOM one", "[parsing]")
+{
+    const std::string request = GENERATE(
+        R"([])",
+        R"({"subject_requests": []})",
+        R"({"subject_requests": {}})",
+        R"({"subject_requests": [1]})",
+        R"({"subject_requests": [{"id": 1, "complexity": 1, "professor": 1,
+            "groups": [-1], "lessons": [1], "classrooms": [[1]]}]})",
+        R"({"subject_requests": [{"id": 1, "complexity": 1, "professor": 1,
+            "groups": [1], "lessons": [84], "classrooms": [[1]]}]})",
+        R"({"subject_requests": [{"id": 1, "complexity": 1, "professor": 1,
+            "groups": [1], "lessons": [-0.5], "classrooms": [[1]]}]})",
+        R"({"subject_requests": [{"id": 1, "complexity": 1, "professor": 1,
+            "groups": [1], "lessons": 1, "classrooms": [[1]]}]})",
+        R"({"subject_requests": [{"id": 1, "complexity": 1, "professor": 1,
+            "groups": [1], "lessons": [1], "classrooms": [1]}]})",
+        R"({"subject_requests": [{"id": 1, "complexity": 1, "professor": 1,
+            "groups": [1], "lessons": [1], "classrooms": [[-1]]}]})",
+        R"({"subject_requests": [{"id": 1, "complexity": 1, "professor": 1,
+            "groups": [[1]], "lessons": [1], "classrooms": [[1]]}]})",
+        R"({"subject_requests": [{"id": "1", "complexity": 1, "professor": 1,
+            "groups": [1], "lessons": [1], "classrooms": [[1]]}]})",
+        R"({"subject_requests": [{"id": 1, "complexity": 1,
+            "groups": [1], "lessons": [1], "classrooms": [[1]]}]})",
+        R"({"subject_requests": [{"id": 1, "complexity": 1, "professor": 1,
+            "groups": [1], "lessons": [1], "classrooms": [[1]]}], "blocks": [1]})",
+        R"({"subject_requests": [{"id": 1, "complexity": 1, "professor": 1,
+            "groups": [1], "lessons": [1], "classrooms": [[1]]})");
+
+    REQUIRE_THROWS(nlohmann::json::parse(request).get<ScheduleData>());
+
+    std::istringstream body(request);
+    nlohmann::json rest;
+    REQUIRE_THROWS(ReadScheduleData(body, nlohmann::json::input_format_t::json, rest));
+}
+
+TEST_CASE("Streaming parser leaves the data of the instance request", "[parsing]")
+{
+    std::istringstream body(R"({"instance": 7, "placed_lessons": []})");
+    nlohmann::json rest;
+    REQUIRE_FALSE(ReadScheduleData(body, nlohmann::json::input_format_t::json, rest).has_value());
+    REQUIRE(rest == R"({"instance": 7, "placed_lessons": []})"_json);
+}
+
+TEST_CASE("Parsing GA params", "[parsing]")
+{
+    SECTION("Islands options are optional")
+    {
+        const ScheduleGAParams params = R"({
+            "individuals_count": 100,
+            "iterations_count": 10,
+            "selection_count": 30,
+            "crossover_count": 20,
+            "mutation_chance": 45
+        })"_json;
+
+        REQUIRE(params.IndividualsCount == 100);
+        REQUIRE(params.IslandsCount == ScheduleGA::DefaultParams().IslandsCount);
+        REQUIRE(params.MigrationInterval == ScheduleGA::DefaultParams().MigrationInterval);
+    }
+    SECTION("Islands options parsed successfully")
+    {
+        const ScheduleGAParams params = R"({
+            "individuals_count": 100,
+            "iterations_count": 10,
+            "selection_count": 30,
+            "crossover_count": 20,
+            "mutation_chance": 45,
+            "islands_count": 8,
+            "migration_interval": 25
+        })"_json;
+
+        REQUIRE(params.IslandsCount == 8);
+        REQUIRE(params.MigrationInterval == 25);
+    }
+}
+
+TEST_CASE("Parsing progress stream options", "[parsing]")
+{
+    SECTION("Progress is streamed by the Accept header")
+    {
+        const auto options = ParseProgressStreamOptions("text/event-stream", {});
+        REQUIRE(options.has_value());
+        REQUIRE(options->Interval == ScheduleProgressStreamOptions{}.Interval);
+        REQUIRE_FALSE(options->WithSchedule);
+
+        REQUIRE_FALSE(ParseProgressStreamOptions("application/json", {}).has_value());
+    }
+    SECTION("Stream parameter overrides the Accept header")
+    {
+        REQUIRE(ParseProgressStreamOptions("application/json", {{"stream", ""}}).has_value());
+        REQUIRE(ParseProgressStreamOptions("", {{"stream", "true"}}).has_value());
+        REQUIRE_FALSE(ParseProgressStreamOptions("text/event-stream", {{"stream", "0"}}));
+        REQUIRE_THROWS_AS(ParseProgressStreamOptions("", {{"stream", "yes"}}),
+                          std::invalid_argument);
+    }
+    SECTION("Progress interval is positive")
+    {
+        const auto options = ParseProgressStreamOptions("", {{"stream", "1"},
+                                                             {"progress_interval", "25"}});
+        REQUIRE(options.has_value());
+        REQUIRE(options->Interval == 25);
+
+        for(auto&& interval : {"0", "-1", "10x", ""})
+        {
+            REQUIRE_THROWS_AS(
+                ParseProgressStreamOptions("", {{"stream", "1"}, {"progress_interval", interval}}),
+                std::invalid_argument);
+        }
+    }
+    SECTION("Schedule is included by the with_schedule parameter")
+    {
+        const auto options = ParseProgressStreamOptions("text/event-stream",
+                                                        {{"with_schedule", ""}});
+        REQUIRE(options.has_value());
+        REQUIRE(options->WithSchedule);
+
+        REQUIRE_FALSE(
+            ParseProgressStreamOptions("text/event-stream", {{"with_schedule", "false"}})
+                ->WithSchedule);
+    }
+}
+
+TEST_CASE("Progress events are framed as server-sent events", "[parsing]")
+{
+    std::ostringstream os;
+    WriteEvent(os, "progress", {{"iteration", 10}, {"best_evaluation", 42}});
+    WriteEvent(os, "error", {{"error", "multi\nline"}});
+    REQUIRE(os.str()
+            == "event: progress\ndata: {\"best_evaluation\":42,\"iteration\":10}\n\n"
+               "event: error\ndata: {\"error\":\"multi\\nline\"}\n\n");
+
+    SECTION("Invalid UTF-8 doesn't break the stream")
+    {
+        std::ostringstream invalid;
+        WriteEvent(invalid, "error", {{"error", "\xFF"}});
+        REQUIRE(invalid.str().starts_with("event: error\ndata: {\"error\":"));
+        REQUIRE(invalid.str().ends_with("\"}\n\n"));
+    }
+}
+
+TEST_CASE("Wire formats are negotiated by the media types", "[wire_format]")
+{
+    REQUIRE(RequestWireFormat("") == ScheduleWireFormat::Json);
+    REQUIRE(RequestWireFormat("application/json; charset=utf-8") == ScheduleWireFormat::Json);
+    REQUIRE(RequestWireFormat("application/cbor") == ScheduleWireFormat::Cbor);
+    REQUIRE(RequestWireFormat("application/x-msgpack") == ScheduleWireFormat::MessagePack);
+
+    REQUIRE(ResponseWireFormat("") == ScheduleWireFormat::Json);
+    REQUIRE(ResponseWireFormat("*/*") == ScheduleWireFormat::Json);
+    REQUIRE(ResponseWireFormat("text/html, application/msgpack;q=0.9, application/cbor")
+            == ScheduleWireFormat::MessagePack);
+    REQUIRE(ResponseWireFormat(" application/cbor ,text/json") == ScheduleWireFormat::Cbor);
+}
+
+TEST_CASE("Wire formats keep the JSON schema", "[wire_format]")
+{
+    const auto jsonData = R"(
+        {
+            "subject_requests": [
+                {"id": 1, "complexity": 1, "professor": 1, "groups": [1, 2],
+                 "lessons": [0, 1, 2], "classrooms": [[1, 2]]},
+                {"id": 2, "complexity": 1, "professor": 2, "groups": [1],
+                 "lessons": [1, 2], "classrooms": [[1], [2]]}
+            ],
+            "placed_lessons": [{"address": 1, "subject_request_id": 1, "classroom": 2}]
+        }
+    )"_json;
+
+    const auto format = GENERATE(
+        ScheduleWireFormat::Json, ScheduleWireFormat::Cbor, ScheduleWireFormat::MessagePack);
+    std::stringstream body;
+    WriteBody(body, jsonData, format);
+
+    nlohmann::json rest;
+    const auto data = ReadScheduleData(body, InputFormat(format), rest);
+    REQUIRE(data.has_value());
+    REQUIRE(data->SubjectRequests() == jsonData.get<ScheduleData>().SubjectRequests());
+    REQUIRE(rest == nlohmann::json{{"placed_lessons", jsonData.at("placed_lessons")}});
+}
+
+TEST_CASE("Streaming writer gives the same JSON as the DOM", "[json_writer]")
+{
+    const int indent = GENERATE(-1, 0, 4);
+    SECTION("Schedule result")
+    {
+        const ScheduleResult result(
+            {ScheduleItem{.Address = 7, .SubjectRequestID = 1, .Classroom = 4},
+             ScheduleItem{.Address = 0, .SubjectRequestID = 2, .Classroom = 1}});
+        std::ostringstream os;
+        WriteJson(os, result, indent);
+        REQUIRE(os.str() == nlohmann::json(result).dump(indent));
+
+        std::ostringstream emptyOs;
+        WriteJson(emptyOs, ScheduleResult{}, indent);
+        REQUIRE(emptyOs.str() == nlohmann::json(ScheduleResult{}).dump(indent));
+    }
+    SECTION("Check schedule result")
+    {
+        const CheckScheduleResult result{
+            .OverlappedClassroomsList = {OverlappedClassroom{
+                .Address = 1, .Classroom = 2, .SubjectRequestsIDs = {3, 4}}},
+            .OverlappedProfessorsList = {},
+            .OverlappedGroupsList = {OverlappedGroups{
+                .Address = 5, .Groups = {1}, .SubjectRequestsIDs = {6, 7}}},
+            .ViolatedLessons = {ViolatedLessonRequest{.Address = 8, .SubjectRequestID = 9}},
+            .OutOfBlockRequests = {10, 11}};
+        std::ostringstream os;
+        WriteJson(os, result, indent);
+        REQUIRE(os.str() == nlohmann::json(result).dump(indent));
+    }
+}
+
 TEST_CASE("Integration test #1", "[integration]")
 {
     const auto jsonData = R"(
@@ -905,13 +1235,17 @@ TEST_CASE("Integration test #1", "[integration]")
     }
     )"_json;
 
+    const int islandsCount = GENERATE(1, 4);
+
     ScheduleGA generator;
     generator.SetParams(ScheduleGAParams{
         .IndividualsCount = 50,
         .IterationsCount = 20,
         .SelectionCount = 16,
         .CrossoverCount = 12,
-        .MutationChance = 39
+        .MutationChance = 39,
+        .IslandsCount = islandsCount,
+        .MigrationInterval = 5
     });
 
     const ScheduleData scheduleData = jsonData;
@@ -1020,3 +1354,438 @@ TEST_CASE("Integration test with blocks", "[integration]")
     const CheckScheduleResult checkResult = CheckSchedule(scheduleData, jsonResult);
     REQUIRE(empty(checkResult));
 }
+
+static ScheduleData MakeJobsTestData()
+{
+    // [id, professor, complexity, groups, lessons, classrooms]
+    return ScheduleData{{
+        SubjectRequest{1, 1, 1, {1, 2}, {0, 1, 2, 3, 4, 5}, {{0, 1}, {0, 2}}},
+        SubjectRequest{2, 2, 1, {1}, {0, 1, 2, 3, 4, 5}, {{0, 1}, {0, 2}}},
+        SubjectRequest{3, 1, 1, {3}, {0, 1, 2}, {{0, 2}}},
+    }};
+}
+
+TEST_CASE("Solve jobs", "[jobs]")
+{
+    ScheduleGA generator;
+    SECTION("Submitted job is solved")
+    {
+        generator.SetParams(ScheduleGAParams{.IndividualsCount = 20,
+                                             .IterationsCount = 10,
+                                             .SelectionCount = 8,
+                                             .CrossoverCount = 4,
+                                             .MutationChance = 40,
+                                             .Seed = 1});
+        ScheduleJobsManager jobs(generator, 1, 4, 4);
+        const ScheduleData data = MakeJobsTestData();
+
+        const auto id = jobs.Submit(data);
+        REQUIRE(id);
+
+        const auto jobInfo = jobs.Wait(*id);
+        REQUIRE(jobInfo);
+        REQUIRE(jobInfo->Status == ScheduleJobStatus::Done);
+        REQUIRE(jobInfo->Result);
+        REQUIRE(jobInfo->Result->items().size() == data.SubjectRequests().size());
+        REQUIRE(empty(CheckSchedule(data, *jobInfo->Result)));
+
+        SECTION("Finished job is removed on cancel")
+        {
+            REQUIRE(jobs.Cancel(*id));
+            REQUIRE_FALSE(jobs.Find(*id));
+        }
+    }
+    SECTION("Queue is bounded and jobs can be cancelled")
+    {
+        // the solve runs until it is cancelled
+        generator.SetParams(ScheduleGAParams{.IndividualsCount = 20,
+                                             .IterationsCount = std::numeric_limits<int>::max(),
+                                             .SelectionCount = 8,
+                                             .CrossoverCount = 4,
+                                             .MutationChance = 40});
+        ScheduleJobsManager jobs(generator, 1, 1, 4);
+
+        const auto runningID = jobs.Submit(MakeJobsTestData());
+        REQUIRE(runningID);
+        while(jobs.Find(*runningID)->Status == ScheduleJobStatus::Queued)
+            std::this_thread::yield();
+
+        const auto queuedID = jobs.Submit(MakeJobsTestData());
+        REQUIRE(queuedID);
+        REQUIRE_FALSE(jobs.Submit(MakeJobsTestData()));
+        REQUIRE(jobs.QueuedJobsCount() == 1);
+
+        REQUIRE(jobs.Cancel(*queuedID)->Status == ScheduleJobStatus::Cancelled);
+        REQUIRE(jobs.QueuedJobsCount() == 0);
+
+        REQUIRE(jobs.Cancel(*runningID));
+        const auto jobInfo = jobs.Wait(*runningID);
+        REQUIRE(jobInfo->Status == ScheduleJobStatus::Cancelled);
+        REQUIRE(jobInfo->StopReason == ScheduleGAStopReason::Cancelled);
+        // the best schedule found before cancellation is kept
+        REQUIRE(jobInfo->Result);
+    }
+    SECTION("Unknown job is not found")
+    {
+        ScheduleJobsManager jobs(generator, 1, 1, 1);
+        REQUIRE_FALSE(jobs.Find(42));
+        REQUIRE_FALSE(jobs.Cancel(42));
+    }
+}
+
+TEST_CASE("Editing sessions re-optimize the schedule after every edit", "[sessions]")
+{
+    ScheduleGA generator;
+    generator.SetParams(ScheduleGAParams{.IndividualsCount = 20,
+                                         .IterationsCount = 10,
+                                         .SelectionCount = 8,
+                                         .CrossoverCount = 4,
+                                         .MutationChance = 40,
+                                         .Seed = 1});
+    ScheduleSessions sessions(generator, std::chrono::milliseconds{50}, 1);
+
+    const auto created = sessions.Create(MakeJobsTestData());
+    REQUIRE(created);
+    REQUIRE(created->Version == 0);
+    REQUIRE(created->Schedule.items().size() == 3);
+    REQUIRE_FALSE(sessions.Create(MakeJobsTestData()));
+
+    const auto session = sessions.Find(created->ID);
+    REQUIRE(session != nullptr);
+
+    auto requests = MakeJobsTestData().SubjectRequests();
+    const SubjectRequest added{4, 3, 1, {1}, {0, 1, 2, 3, 4, 5}, {{0, 1}}};
+    auto state = session->AddRequest(added);
+    requests.emplace_back(added);
+    REQUIRE(state.Version == 1);
+    // request 4 shares the group with requests 1 and 2
+    REQUIRE(state.AffectedRequests == std::vector<std::size_t>{1, 2, 4});
+    REQUIRE(state.Schedule.items().size() == 4);
+    REQUIRE(empty(CheckSchedule(ScheduleData(requests), state.Schedule)));
+
+    REQUIRE_THROWS_AS(session->AddRequest(added), std::invalid_argument);
+    REQUIRE(session->State().Version == 1);
+
+    const SubjectRequest modified{4, 3, 1, {1}, {6, 7}, {{0, 1}}};
+    state = session->ModifyRequest(modified);
+    requests.back() = modified;
+    REQUIRE(state.Version == 2);
+    const auto modifiedItem =
+        std::ranges::find(state.Schedule, std::size_t{4}, &ScheduleItem::SubjectRequestID);
+    REQUIRE(modifiedItem != state.Schedule.end());
+    REQUIRE((modifiedItem->Address == 6 || modifiedItem->Address == 7));
+    REQUIRE(empty(CheckSchedule(ScheduleData(requests), state.Schedule)));
+
+    state = session->RemoveRequest(4);
+    REQUIRE(state.Version == 3);
+    REQUIRE(state.AffectedRequests == std::vector<std::size_t>{1, 2});
+    REQUIRE(state.Schedule.items().size() == 3);
+    REQUIRE_THROWS_AS(session->RemoveRequest(4), std::out_of_range);
+
+    REQUIRE(sessions.Remove(created->ID));
+    REQUIRE(sessions.Find(created->ID) == nullptr);
+    REQUIRE(sessions.Create(MakeJobsTestData()));
+}
+
+TEST_CASE("Registered instances are shared by the solves", "[instances]")
+{
+    ScheduleInstances instances(1);
+    const auto data = std::make_shared<const ScheduleData>(MakeJobsTestData());
+
+    const auto id = instances.Register(data);
+    REQUIRE(id);
+    REQUIRE(instances.Find(*id) == data);
+    REQUIRE_FALSE(instances.Register(std::make_shared<const ScheduleData>(MakeJobsTestData())));
+
+    ScheduleGA generator;
+    generator.SetParams(ScheduleGAParams{.IndividualsCount = 20,
+                                         .IterationsCount = 10,
+                                         .SelectionCount = 8,
+                                         .CrossoverCount = 4,
+                                         .MutationChance = 40,
+                                         .Seed = 1});
+    ScheduleJobsManager jobs(generator, 1, 4, 4);
+    const auto jobID = jobs.Submit(instances.Find(*id));
+    REQUIRE(jobID);
+
+    // the removed instance lives while it is referenced
+    REQUIRE(instances.Remove(*id));
+    REQUIRE(instances.Find(*id) == nullptr);
+    REQUIRE_FALSE(instances.Remove(*id));
+
+    const auto jobInfo = jobs.Wait(*jobID);
+    REQUIRE(jobInfo->Status == ScheduleJobStatus::Done);
+    REQUIRE(empty(CheckSchedule(*data, *jobInfo->Result)));
+    REQUIRE(instances.Register(data));
+}
+
+TEST_CASE("Cache key depends on the parsed data and GA params", "[cache]")
+{
+    const auto jsonData = R"(
+        {
+            "subject_requests": [
+                {"id": 1, "complexity": 1, "professor": 1, "groups": [1, 2],
+                 "lessons": [0, 1, 2], "classrooms": [[1, 2]]},
+                {"id": 2, "complexity": 1, "professor": 2, "groups": [1],
+                 "lessons": [1, 2], "classrooms": [[1], [2]]}
+            ]
+        }
+    )"_json;
+    const auto reorderedJsonData = R"(
+        {
+            "subject_requests": [
+                {"id": 2, "complexity": 1, "professor": 2, "groups": [1, 1],
+                 "lessons": [2, 1], "classrooms": [[1], [2]]},
+                {"id": 1, "complexity": 1, "professor": 1, "groups": [2, 1],
+                 "lessons": [0, 1, 2], "classrooms": [[2, 1]]}
+            ]
+        }
+    )"_json;
+
+    const ScheduleData data = jsonData;
+    const auto params = ScheduleGA::DefaultParams();
+    const auto key = MakeScheduleCacheKey(data, params);
+
+    REQUIRE(MakeScheduleCacheKey(reorderedJsonData.get<ScheduleData>(), params) == key);
+
+    auto otherParams = params;
+    otherParams.Seed = 42;
+    REQUIRE(MakeScheduleCacheKey(data, otherParams) != key);
+
+    auto otherJsonData = jsonData;
+    otherJsonData["subject_requests"][1]["lessons"] = {1, 3};
+    REQUIRE(MakeScheduleCacheKey(otherJsonData.get<ScheduleData>(), params) != key);
+
+    const auto prior = R"(
+        [
+            {"address": 1, "subject_request_id": 1, "classroom": 2},
+            {"address": 1, "subject_request_id": 2, "classroom": 1}
+        ]
+    )"_json;
+    const auto reorderedPrior = R"(
+        [
+            {"address": 1, "subject_request_id": 2, "classroom": 1},
+            {"address": 1, "subject_request_id": 1, "classroom": 2}
+        ]
+    )"_json;
+    const auto warmKey = MakeScheduleCacheKey(data, params, prior.get<ScheduleResult>());
+    REQUIRE(warmKey != key);
+    REQUIRE(MakeScheduleCacheKey(data, params, reorderedPrior.get<ScheduleResult>()) == warmKey);
+    REQUIRE(MakeScheduleCacheKey(data, params, ScheduleResult{}) != key);
+}
+
+TEST_CASE("Results cache evicts least recently used results", "[cache]")
+{
+    const auto result = std::make_shared<const ScheduleResult>(std::vector<ScheduleItem>{
+        ScheduleItem{.Address = 0, .SubjectRequestID = 1, .Classroom = 2},
+        ScheduleItem{.Address = 1, .SubjectRequestID = 2, .Classroom = 3}});
+    const ScheduleCacheKey first{.High = 1, .Low = 1};
+    const ScheduleCacheKey second{.High = 2, .Low = 2};
+    const ScheduleCacheKey third{.High = 3, .Low = 3};
+
+    ScheduleResultCache sizingCache(std::numeric_limits<std::size_t>::max());
+    sizingCache.Insert(first, result);
+    const std::size_t entrySize = sizingCache.Stats().Size;
+
+    SECTION("Results are found until they are evicted")
+    {
+        ScheduleResultCache cache(entrySize * 2);
+        REQUIRE(cache.Find(first) == nullptr);
+
+        cache.Insert(first, result);
+        cache.Insert(second, result);
+        const auto cachedResult = cache.Find(first);
+        REQUIRE(cachedResult != nullptr);
+        REQUIRE(cachedResult == result);
+
+        // the second result is the least recently used now
+        cache.Insert(third, result);
+        REQUIRE(cache.Find(first) != nullptr);
+        REQUIRE(cache.Find(second) == nullptr);
+        REQUIRE(cache.Find(third) != nullptr);
+
+        const auto stats = cache.Stats();
+        REQUIRE(stats.Hits == 3);
+        REQUIRE(stats.Misses == 2);
+        REQUIRE(stats.EntriesCount == 2);
+        REQUIRE(stats.Size == entrySize * 2);
+        REQUIRE(stats.Capacity == entrySize * 2);
+    }
+    SECTION("Disabled cache keeps nothing")
+    {
+        ScheduleResultCache cache(0);
+        cache.Insert(first, result);
+        REQUIRE(cache.Find(first) == nullptr);
+        REQUIRE(cache.Stats().EntriesCount == 0);
+    }
+}
+
+TEST_CASE("Identical concurrent solves share one flight", "[single_flight]")
+{
+    const ScheduleCacheKey key{.High = 1, .Low = 2};
+    ScheduleSolveFlights flights;
+
+    const auto [leaderFlight, leader] = flights.Join(key);
+    REQUIRE(leader);
+
+    const auto [followerFlight, follower] = flights.Join(key);
+    REQUIRE_FALSE(follower);
+    REQUIRE(followerFlight == leaderFlight);
+
+    SECTION("Waiting participants get the outcome of the leader")
+    {
+        bool completed = false;
+        std::jthread waiter([&, flight = followerFlight] { completed = flight->Wait({}); });
+
+        const auto result = std::make_shared<const ScheduleResult>();
+        flights.Finish(key, leaderFlight);
+        leaderFlight->Complete(ScheduleSolveOutcome{.Result = result});
+        waiter.join();
+
+        REQUIRE(completed);
+        REQUIRE(followerFlight->Outcome().Result == result);
+        REQUIRE(flights.Count() == 0);
+        REQUIRE(flights.Join(key).second);
+    }
+    SECTION("Solve is stopped when all participants have left")
+    {
+        leaderFlight->Leave();
+        REQUIRE_FALSE(leaderFlight->StopRequested());
+
+        followerFlight->Leave();
+        REQUIRE(leaderFlight->StopRequested());
+
+        // the abandoned flight is not joined anymore
+        const auto [newFlight, newLeader] = flights.Join(key);
+        REQUIRE(newLeader);
+        REQUIRE(newFlight != leaderFlight);
+
+        // the abandoned flight doesn't remove the new one
+        flights.Finish(key, leaderFlight);
+        REQUIRE(flights.Count() == 1);
+    }
+    SECTION("Participant stops waiting when its own stop is requested")
+    {
+        std::stop_source stopSource;
+        stopSource.request_stop();
+        REQUIRE_FALSE(followerFlight->Wait(stopSource.get_token()));
+        REQUIRE_FALSE(followerFlight->Completed());
+    }
+}
+
+TEST_CASE("Admission bounds the running and waiting solves", "[admission]")
+{
+    ScheduleAdmission admission(1, 1);
+    REQUIRE_FALSE(admission.Saturated());
+    REQUIRE_FALSE(admission.TryReject());
+
+    auto first = admission.Acquire();
+    REQUIRE(first.has_value());
+    REQUIRE_FALSE(admission.Saturated());
+
+    SECTION("Waiting solve is admitted when the slot is released")
+    {
+        std::optional<ScheduleAdmission::Permit> second;
+        std::jthread waiter(
+            [&]
+            {
+                if(auto permit = admission.Acquire())
+                    second.emplace(std::move(*permit));
+            });
+        while(admission.Stats().QueuedCount == 0)
+            std::this_thread::yield();
+
+        REQUIRE(admission.Saturated());
+        REQUIRE(admission.TryReject());
+        REQUIRE_FALSE(admission.Acquire().has_value());
+
+        first.reset();
+        waiter.join();
+        REQUIRE(second.has_value());
+
+        const auto stats = admission.Stats();
+        REQUIRE(stats.ActiveCount == 1);
+        REQUIRE(stats.QueuedCount == 0);
+        REQUIRE(stats.Admitted == 2);
+        REQUIRE(stats.Rejected == 2);
+        REQUIRE(stats.MaxWait >= stats.AverageWait);
+        REQUIRE(admission.RetryAfter() >= std::chrono::seconds{1});
+    }
+    SECTION("Waiting solve leaves the queue when its stop is requested")
+    {
+        std::stop_source stopSource;
+        bool admitted = true;
+        std::jthread waiter([&]
+                            { admitted = admission.Acquire(stopSource.get_token()).has_value(); });
+        while(admission.Stats().QueuedCount == 0)
+            std::this_thread::yield();
+
+        stopSource.request_stop();
+        waiter.join();
+        REQUIRE_FALSE(admitted);
+        REQUIRE(admission.Stats().QueuedCount == 0);
+        REQUIRE(admission.Stats().Rejected == 0);
+    }
+}
+
+TEST_CASE("Endpoints are found by the request path", "[metrics]")
+{
+    REQUIRE(FindScheduleEndpoint("/makeSchedule") == ScheduleEndpoint::MakeSchedule);
+    REQUIRE(FindScheduleEndpoint("/metrics") == ScheduleEndpoint::Metrics);
+    REQUIRE(FindScheduleEndpoint("/jobs") == ScheduleEndpoint::Jobs);
+    REQUIRE(FindScheduleEndpoint("/sessions/1/requests/2") == ScheduleEndpoint::Sessions);
+    REQUIRE_FALSE(FindScheduleEndpoint("/makeSchedule/1").has_value());
+    REQUIRE_FALSE(FindScheduleEndpoint("/jobsList").has_value());
+    REQUIRE_FALSE(FindScheduleEndpoint("/").has_value());
+}
+
+TEST_CASE("Metrics are written in the Prometheus text format", "[metrics]")
+{
+    using namespace std::chrono_literals;
+
+    ScheduleMetrics metrics;
+    {
+        // the best evaluation is unknown until the first solve is finished
+        std::ostringstream os;
+        metrics.Write(os, ScheduleAdmissionStats{}, ScheduleCacheStats{});
+        REQUIRE(os.str().find("schedule_ga_best_evaluation") == std::string::npos);
+        REQUIRE(os.str().find("schedule_ga_solves_total 0\n") != std::string::npos);
+    }
+
+    metrics.RecordRequest(ScheduleEndpoint::MakeSchedule, 200, 20ms);
+    metrics.RecordRequest(ScheduleEndpoint::MakeSchedule, 400, 2s);
+    metrics.RecordPhase(ScheduleSolvePhase::Parse, 3ms);
+    metrics.RecordSolve(500, 42, 2s);
+
+    std::ostringstream os;
+    metrics.Write(os,
+                  ScheduleAdmissionStats{.ActiveCount = 1, .QueuedCount = 2},
+                  ScheduleCacheStats{.Hits = 3, .Misses = 4});
+    const std::string text = os.str();
+    const auto contains = [&](const std::string& line)
+    { return text.find(line + '\n') != std::string::npos; };
+
+    REQUIRE(contains("# TYPE schedule_http_request_duration_seconds histogram"));
+    REQUIRE(contains(R"(schedule_http_requests_total{endpoint="makeSchedule",code="2xx"} 1)"));
+    REQUIRE(contains(R"(schedule_http_requests_total{endpoint="makeSchedule",code="4xx"} 1)"));
+    REQUIRE(contains(R"(schedule_http_requests_total{endpoint="jobs",code="2xx"} 0)"));
+    // buckets are cumulative
+    REQUIRE(contains(
+        R"(schedule_http_request_duration_seconds_bucket{endpoint="makeSchedule",le="0.01"} 0)"));
+    REQUIRE(contains(
+        R"(schedule_http_request_duration_seconds_bucket{endpoint="makeSchedule",le="0.05"} 1)"));
+    REQUIRE(contains(
+        R"(schedule_http_request_duration_seconds_bucket{endpoint="makeSchedule",le="+Inf"} 2)"));
+    REQUIRE(
+        contains(R"(schedule_http_request_duration_seconds_sum{endpoint="makeSchedule"} 2.02)"));
+    REQUIRE(contains(R"(schedule_http_request_duration_seconds_count{endpoint="makeSchedule"} 2)"));
+    REQUIRE(contains(R"(schedule_solve_phase_duration_seconds_count{phase="parse"} 1)"));
+    REQUIRE(contains(R"(schedule_solve_phase_duration_seconds_count{phase="solve"} 0)"));
+    REQUIRE(contains("schedule_ga_iterations_total 500"));
+    REQUIRE(contains("schedule_ga_iterations_per_second 250"));
+    REQUIRE(contains("schedule_ga_best_evaluation 42"));
+    REQUIRE(contains("schedule_active_solves 1"));
+    REQUIRE(contains("schedule_queued_solves 2"));
+    REQUIRE(contains("schedule_cache_hits_total 3"));
+    REQUIRE(contains("schedule_cache_misses_total 4"));
+}